@@ -0,0 +1,56 @@
+#include "core/allocator.h"
+#include "core/runtime.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+
+namespace infini {
+
+// Allocates n blocks and frees them in allocation order.
+static void BM_AllocFreeFifo(benchmark::State &state) {
+    size_t n = state.range(0);
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    vector<size_t> offsets(n);
+    for (auto _ : state) {
+        Allocator allocator(runtime);
+        for (size_t i = 0; i < n; ++i)
+            offsets[i] = allocator.alloc(256);
+        for (size_t i = 0; i < n; ++i)
+            allocator.free(offsets[i], 256);
+    }
+    state.SetItemsProcessed(state.iterations() * n * 2);
+}
+
+// Allocates n blocks of random sizes while freeing a random live block every
+// other step, which keeps the free list fragmented.
+static void BM_AllocFreeRandom(benchmark::State &state) {
+    size_t n = state.range(0);
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<size_t> sizeDist(16, 4096);
+    vector<pair<size_t, size_t>> requests(n);
+    for (auto &r : requests)
+        r.second = sizeDist(gen);
+    for (auto _ : state) {
+        Allocator allocator(runtime);
+        vector<pair<size_t, size_t>> live;
+        std::mt19937 pick(1);
+        for (size_t i = 0; i < n; ++i) {
+            live.emplace_back(allocator.alloc(requests[i].second),
+                              requests[i].second);
+            if (i % 2 == 1) {
+                auto idx = pick() % live.size();
+                allocator.free(live[idx].first, live[idx].second);
+                live[idx] = live.back();
+                live.pop_back();
+            }
+        }
+        benchmark::DoNotOptimize(live.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n * 3 / 2);
+}
+
+BENCHMARK(BM_AllocFreeFifo)->RangeMultiplier(10)->Range(100, 10000);
+BENCHMARK(BM_AllocFreeRandom)->RangeMultiplier(10)->Range(100, 10000);
+
+} // namespace infini
@@ -0,0 +1,108 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include "utils/data_generator.h"
+#include "utils/graph_generator.h"
+
+#include <benchmark/benchmark.h>
+
+namespace infini {
+
+// Builds a synthetic graph of about `n` operators.
+static Graph buildGraph(int kind, int n) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    switch (kind) {
+    case 0:
+        return makeChainGraph(runtime, n, {16});
+    case 1:
+        return makeFanOutGraph(runtime, n / 10, 10, {16});
+    default:
+        // 7 * 4 + 9 = 37 operators per layer
+        return makeTransformerGraph(runtime, std::max(n / 37, 1), 8, 16, 4);
+    }
+}
+
+static void BM_BuildGraph(benchmark::State &state) {
+    for (auto _ : state)
+        benchmark::DoNotOptimize(buildGraph(state.range(0), state.range(1)));
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+static void BM_TopoSort(benchmark::State &state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto g = buildGraph(state.range(0), state.range(1));
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(g->topo_sort());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+static void BM_Optimize(benchmark::State &state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto g = buildGraph(state.range(0), state.range(1));
+        state.ResumeTiming();
+        g->optimize();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+static void BM_DataMalloc(benchmark::State &state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto g = buildGraph(state.range(0), state.range(1));
+        state.ResumeTiming();
+        g->dataMalloc();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+// End-to-end latency of `run` on a small MLP-like block repeated `n` times:
+// MatMul -> Add -> Relu -> Transpose -> Transpose.
+static void BM_Run(benchmark::State &state) {
+    int n = state.range(0), d = state.range(1);
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor({d, d}, DataType::Float32);
+    for (int i = 0; i < n; ++i) {
+        auto w = g->addTensor({d, d}, DataType::Float32);
+        auto bias = g->addTensor({d}, DataType::Float32);
+        x = g->addOp<MatmulObj>(x, w, nullptr)->getOutput();
+        x = g->addOp<AddObj>(x, bias, nullptr)->getOutput();
+        x = g->addOp<ReluObj>(x, nullptr)->getOutput();
+        x = g->addOp<TransposeObj>(x, nullptr, vector<int>{1, 0})->getOutput();
+        x = g->addOp<TransposeObj>(x, nullptr, vector<int>{1, 0})->getOutput();
+    }
+    g->dataMalloc();
+    for (auto &t : g->getInputs())
+        t->setData(OneGenerator());
+    for (auto _ : state)
+        runtime->run(g);
+    state.SetItemsProcessed(state.iterations() * g->getOperators().size());
+}
+
+// {chain, fan-out, transformer} x {1k, 10k, 100k} operators
+static void GraphMatrix(benchmark::internal::Benchmark *b) {
+    b->ArgNames({"kind", "ops"});
+    for (int64_t kind : {0, 1, 2})
+        for (int64_t n : {1000, 10000, 100000})
+            b->Args({kind, n});
+    b->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK(BM_BuildGraph)->Apply(GraphMatrix);
+BENCHMARK(BM_TopoSort)->Apply(GraphMatrix);
+BENCHMARK(BM_Optimize)->Apply(GraphMatrix);
+BENCHMARK(BM_DataMalloc)->Apply(GraphMatrix);
+BENCHMARK(BM_Run)
+    ->ArgNames({"blocks", "d"})
+    ->Args({4, 64})
+    ->Args({16, 64})
+    ->Args({4, 256})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace infini
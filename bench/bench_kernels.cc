@@ -0,0 +1,167 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include "utils/data_generator.h"
+
+#include <benchmark/benchmark.h>
+
+namespace infini {
+
+// Runs one kernel variant of the only operator in `g` over and over.
+static void runKernel(benchmark::State &state, const Graph &g,
+                      const string &kernelName) {
+    auto op = g->getOperators()[0];
+    g->dataMalloc();
+    for (auto &t : g->getInputs())
+        t->setData(OneGenerator());
+    auto runtime = g->getRuntime();
+    auto kernelAttrs = KernelAttrs{Device::CPU, op->getOpType().underlying()};
+    auto record =
+        KernelRegistry::getInstance().getKernelItem(kernelAttrs, kernelName);
+    if (!record) {
+        state.SkipWithError(("No kernel named " + kernelName).c_str());
+        return;
+    }
+    auto kernel = std::get<0>(*record);
+    // the workspace is allocated once, as a planned graph would
+    size_t workspaceBytes = kernel->getWorkspaceSize(op);
+    vector<std::max_align_t> workspace(
+        (workspaceBytes + sizeof(std::max_align_t) - 1) /
+        sizeof(std::max_align_t));
+    void *ws = workspaceBytes > 0 ? workspace.data() : nullptr;
+    for (auto _ : state)
+        kernel->compute(op, ws, runtime.get());
+
+    size_t bytes = 0;
+    for (auto &t : op->getInputs())
+        bytes += t->getBytes();
+    for (auto &t : op->getOutputs())
+        bytes += t->getBytes();
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.SetLabel(kernelName);
+}
+
+static DataType getDType(int64_t idx) {
+    return idx == 0 ? DataType::Float32 : DataType::UInt32;
+}
+
+// Computes [n, n] op [n, n], or [n, n] op [n] if broadcast
+static void BM_ElementWise(benchmark::State &state, OpType type,
+                           bool broadcast, const string &name) {
+    int n = state.range(0);
+    auto dtype = getDType(state.range(1));
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    auto a = g->addTensor({n, n}, dtype);
+    auto b = g->addTensor(broadcast ? Shape{n} : Shape{n, n}, dtype);
+    switch (type.underlying()) {
+    case OpType::Add:
+        g->addOp<AddObj>(a, b, nullptr);
+        break;
+    case OpType::Sub:
+        g->addOp<SubObj>(a, b, nullptr);
+        break;
+    case OpType::Mul:
+        g->addOp<MulObj>(a, b, nullptr);
+        break;
+    case OpType::Div:
+        g->addOp<DivObj>(a, b, nullptr);
+        break;
+    default:
+        IT_TODO_HALT();
+    }
+    runKernel(state, g, name);
+}
+
+static void BM_Relu(benchmark::State &state) {
+    int n = state.range(0);
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    auto a = g->addTensor({n, n}, getDType(state.range(1)));
+    g->addOp<ReluObj>(a, nullptr);
+    runKernel(state, g, "reluNaive_CPU");
+}
+
+static void BM_Clip(benchmark::State &state) {
+    int n = state.range(0);
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    auto a = g->addTensor({n, n}, getDType(state.range(1)));
+    g->addOp<ClipObj>(a, nullptr, 0.f, 1.f);
+    runKernel(state, g, "Clip_CPU");
+}
+
+// Swaps the last two dims of [4, n, n]
+static void BM_Transpose(benchmark::State &state, const string &name) {
+    int n = state.range(0);
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    auto a = g->addTensor({4, n, n}, getDType(state.range(1)));
+    g->addOp<TransposeObj>(a, nullptr, vector<int>{0, 2, 1});
+    runKernel(state, g, name);
+}
+
+// Concatenates four [n, n] tensors on the last dim
+static void BM_Concat(benchmark::State &state) {
+    int n = state.range(0);
+    auto dtype = getDType(state.range(1));
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    TensorVec inputs;
+    for (int i = 0; i < 4; ++i)
+        inputs.emplace_back(g->addTensor({n, n}, dtype));
+    g->addOp<ConcatObj>(inputs, nullptr, 1);
+    runKernel(state, g, "ConcatNaive_CPU");
+}
+
+static void BM_Matmul(benchmark::State &state, const string &name) {
+    int n = state.range(0);
+    auto dtype = getDType(state.range(1));
+    Graph g = make_ref<GraphObj>(NativeCpuRuntimeObj::getInstance());
+    auto a = g->addTensor({n, n}, dtype);
+    auto b = g->addTensor({n, n}, dtype);
+    g->addOp<MatmulObj>(a, b, nullptr);
+    runKernel(state, g, name);
+    state.counters["FLOPS"] = benchmark::Counter(
+        2.0 * n * n * n * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+// {size} x {Float32, UInt32}
+static void ShapeMatrix(benchmark::internal::Benchmark *b) {
+    b->ArgNames({"n", "dtype"});
+    for (int64_t n : {64, 256, 1024})
+        for (int64_t dtype : {0, 1})
+            b->Args({n, dtype});
+}
+
+static void MatmulShapeMatrix(benchmark::internal::Benchmark *b) {
+    b->ArgNames({"n", "dtype"});
+    for (int64_t n : {32, 128, 256})
+        for (int64_t dtype : {0, 1})
+            b->Args({n, dtype});
+}
+
+BENCHMARK_CAPTURE(BM_ElementWise, add, OpType::Add, false, "addNaive_CPU")
+    ->Apply(ShapeMatrix);
+BENCHMARK_CAPTURE(BM_ElementWise, add_broadcast, OpType::Add, true,
+                  "addNaive_CPU")
+    ->Apply(ShapeMatrix);
+BENCHMARK_CAPTURE(BM_ElementWise, sub, OpType::Sub, false, "subNaive_CPU")
+    ->Apply(ShapeMatrix);
+BENCHMARK_CAPTURE(BM_ElementWise, mul, OpType::Mul, false, "mulNaive_CPU")
+    ->Apply(ShapeMatrix);
+BENCHMARK_CAPTURE(BM_ElementWise, div, OpType::Div, false, "divNaive_CPU")
+    ->Apply(ShapeMatrix);
+BENCHMARK(BM_Relu)->Apply(ShapeMatrix);
+BENCHMARK(BM_Clip)->Apply(ShapeMatrix);
+BENCHMARK_CAPTURE(BM_Transpose, naive, "TransposeNaive_CPU")
+    ->Apply(ShapeMatrix);
+BENCHMARK_CAPTURE(BM_Transpose, strided, "TransposeStrided_CPU")
+    ->Apply(ShapeMatrix);
+BENCHMARK(BM_Concat)->Apply(ShapeMatrix);
+BENCHMARK_CAPTURE(BM_Matmul, naive, "MatmulNaive_CPU")
+    ->Apply(MatmulShapeMatrix);
+BENCHMARK_CAPTURE(BM_Matmul, blocked, "MatmulBlocked_CPU")
+    ->Apply(MatmulShapeMatrix);
+
+} // namespace infini
@@ -30,6 +30,12 @@ namespace infini {
     // pointer to the memory actually allocated
     void *ptr;
 
+    // size of the memory behind ptr
+    size_t capacity;
+
+    // number of actual allocations made by getPtr
+    size_t allocCount;
+
     // =================================== 作业 ===================================
     // TODO：可能需要设计一个数据结构来存储free block，以便于管理和合并
     // HINT: 可以使用一个 map 来存储 free block，key 为 block 的起始/结尾地址，value 为 block 的大小
@@ -52,12 +58,31 @@ namespace infini {
     //     size: size of memory block to be freed
     void free(size_t addr, size_t size);
 
-    // function: perform actual memory allocation
+    // function: perform actual memory allocation, reallocating only if the
+    //           peak has grown beyond the memory allocated before
     // return: pointer to the head address of the allocated memory
     void *getPtr();
 
+    // function: forget all simulated blocks to plan again, keeping the memory
+    //           actually allocated for the next getPtr
+    void reset();
+
+    // function: free the memory actually allocated; tensors bound to it must
+    //           not be used until they are bound again
+    void release();
+
     void info();
 
+    size_t getUsed() const { return used; }
+    size_t getPeak() const { return peak; }
+    size_t getCapacity() const { return capacity; }
+    size_t getAllocCount() const { return allocCount; }
+    size_t getAlignment() const { return alignment; }
+
+    // function: set the alignment of planned offsets, a power of two; must be
+    //           called before planning
+    void setAlignment(size_t alignment);
+
   private:
     // function: memory alignment, rouned up
     // return: size of the aligned memory block
@@ -0,0 +1,78 @@
+#pragma once
+#include "core/graph.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace infini
+{
+
+    /**
+     * @brief Coalesces concurrent inferences on one graph into batches.
+     *
+     * The graph has a single input whose dim 0 is the batch, and every output
+     * is batched along dim 0 too. Submitted requests are queued; a worker
+     * thread concatenates the rows of queued requests along dim 0, like
+     * Concat on the batch dim, until `maxBatch` rows are queued or `timeout`
+     * has passed since the oldest request arrived. It then resizes the graph
+     * with `GraphObj::reshape`, runs it once and splits the outputs back to
+     * the requests. Since reshaping does not preserve arena data, weights
+     * must be bound outside the arena, as done by `loadGraph` and
+     * `importOnnx`.
+     */
+    class Batcher
+    {
+    public:
+        // one buffer per graph output, in the order of `getOutputs`
+        using Result = vector<vector<char>>;
+
+    private:
+        struct Request
+        {
+            vector<char> input;
+            int rows;
+            std::promise<Result> result;
+        };
+
+        Graph graph;
+        Tensor input;
+        size_t rowBytes;
+        int maxBatch;
+        std::chrono::microseconds timeout;
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<Request> queue;
+        int queuedRows = 0;
+        bool stopping = false;
+        size_t batches = 0, requests = 0;
+        std::thread worker;
+
+    public:
+        Batcher(Graph graph, int maxBatch, std::chrono::microseconds timeout);
+        ~Batcher();
+        Batcher(const Batcher &) = delete;
+        Batcher &operator=(const Batcher &) = delete;
+
+        /**
+         * @brief Queues a request of one or more rows, each laid out like one
+         * batch entry of the graph input. Requests with more than `maxBatch`
+         * rows run in a batch of their own.
+         */
+        std::future<Result> submit(vector<char> data);
+
+        /**
+         * @brief Gets the number of graph runs and of requests served.
+         */
+        size_t getBatchCount();
+        size_t getRequestCount();
+
+    private:
+        void loop();
+        void runBatch(vector<Request> &batch, int rows);
+    };
+
+} // namespace infini
@@ -11,9 +11,14 @@ class BlobObj
 {
   Runtime runtime;
   void *ptr;
+  // Keeps the memory behind `ptr` alive if the blob does not point into an
+  // arena, e.g. a memory-mapped model file.
+  Ref<void> owner;
 
 public:
   BlobObj(Runtime runtime, void *ptr) : runtime(runtime), ptr(ptr) {}
+  BlobObj(Runtime runtime, void *ptr, Ref<void> owner)
+      : runtime(runtime), ptr(ptr), owner(std::move(owner)) {}
   BlobObj(BlobObj &other) = delete;
   BlobObj &operator=(BlobObj const &) = delete;
   ~BlobObj() {};
@@ -0,0 +1,93 @@
+#pragma once
+#include "core/graph.h"
+#include <unordered_map>
+
+namespace infini
+{
+
+    /**
+     * @brief Per-request state for running one graph concurrently.
+     *
+     * A context owns an arena laid out by the memory plan of the graph (see
+     * `GraphObj::dataMalloc`) and resolves the data of planned tensors to it.
+     * Weights and tensors bound outside the arena are shared with the graph,
+     * unless tensors bound by `GraphObj::bindExternalData` are given buffers
+     * of this context.
+     * Tensor data accessed on a thread inside a `Scope` of the context,
+     * including by kernels during `run`, resolves to the context, so contexts
+     * of the same graph can run on different threads at once. Kernels must
+     * therefore get data pointers on the calling thread, not in worker
+     * threads. The graph must not be changed or re-planned while contexts
+     * exist.
+     */
+    class ExecutionContext
+    {
+    private:
+        Graph graph;
+        Ref<void> arena;
+        // fuid -> data in the arena, or a buffer bound to this context
+        std::unordered_map<UidBaseType, void *> ptrs;
+        // guid -> workspace of the operator in the arena
+        std::unordered_map<UidBaseType, void *> workspaces;
+
+    public:
+        explicit ExecutionContext(Graph graph);
+        ExecutionContext(const ExecutionContext &) = delete;
+        ExecutionContext &operator=(const ExecutionContext &) = delete;
+
+        /**
+         * @brief Makes tensor data accesses on this thread resolve to a
+         * context while alive. Scopes nest.
+         */
+        class Scope
+        {
+            const ExecutionContext *prev;
+
+        public:
+            explicit Scope(const ExecutionContext &context);
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+            ~Scope();
+        };
+
+        const Graph &getGraph() const { return graph; }
+        void *getArena() const { return arena.get(); }
+
+        /**
+         * @brief Gets the data of a tensor in this context, or nullptr if the
+         * tensor is not planned by the graph.
+         */
+        void *getPtr(UidBaseType fuid) const
+        {
+            auto it = ptrs.find(fuid);
+            return it == ptrs.end() ? nullptr : it->second;
+        }
+
+        /**
+         * @brief Gets the workspace of an operator in this context, or
+         * nullptr if it needs none.
+         */
+        void *getWorkspace(UidBaseType guid) const
+        {
+            auto it = workspaces.find(guid);
+            return it == workspaces.end() ? nullptr : it->second;
+        }
+
+        /**
+         * @brief Binds a caller-owned buffer to a tensor bound by
+         * `GraphObj::bindExternalData` for runs of this context only, e.g.
+         * the payload of one request.
+         */
+        void bindExternalData(const Tensor &tensor, void *ptr);
+
+        template <typename T>
+        T getRawDataPtr(const Tensor &tensor) const
+        {
+            Scope scope(*this);
+            return tensor->getRawDataPtr<T>();
+        }
+
+        void run();
+    };
+
+} // namespace infini
@@ -1,9 +1,16 @@
 #pragma once
 #include "core/allocator.h"
+#include "core/graph_topology.h"
+#include "core/memory_plan.h"
 #include "core/operator.h"
+#include "core/rematerialization.h"
+#include "core/scheduler.h"
 #include "core/tensor.h"
+#include "core/weight_arena.h"
 #include <algorithm>
 #include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
 #include "operators/transpose.h" 
 #include "operators/matmul.h"
 
@@ -14,9 +21,24 @@ namespace infini
     {
     protected:
         Runtime runtime;
-        TensorVec tensors;
-        OpVec ops;
+        // Removed tensors and operators leave nullptr tombstones, dropped by
+        // `compact` before the vectors are iterated. Mutable so const
+        // accessors can compact.
+        mutable TensorVec tensors;
+        mutable OpVec ops;
+        // fuid -> position in `tensors`, guid -> position in `ops`
+        mutable std::unordered_map<UidBaseType, size_t> tensorIndex, opIndex;
+        mutable size_t removedTensors = 0, removedOps = 0;
+        // built on demand, dropped whenever the graph changes
+        mutable Ref<GraphTopology> topology;
         Allocator allocator;
+        MemoryPlan memoryPlan;
+        WeightArena weightArena;
+        // guid -> workspace of the operator in the arena
+        std::unordered_map<UidBaseType, void *> workspaces;
+        // per step, empty unless the arena is spilled to a file
+        vector<PageHints> pageHints;
+        char *arenaBase = nullptr;
 
     public:
         explicit GraphObj(Runtime runtime)
@@ -27,23 +49,36 @@ namespace infini
         Tensor addTensor(Shape dim, DataType dtype = DataType::Float32);
         Tensor addTensor(const Tensor &tensor);
         TensorVec addTensor(const TensorVec &tensors);
-        void removeOperator(Operator op)
+        /**
+         * @brief Removes an operator or a tensor in constant time. Their
+         * connections are left to the caller.
+         */
+        void removeOperator(Operator op);
+        void removeTensor(Tensor tensor);
+
+        const TensorVec &getTensors() const
         {
-            auto it = std::find(ops.begin(), ops.end(), op);
-            if (it != ops.end())
-                ops.erase(it);
+            compact();
+            return tensors;
         }
-
-        void removeTensor(Tensor tensor)
+        const OpVec &getOperators() const
         {
-            auto it = std::find(tensors.begin(), tensors.end(), tensor);
-            if (it != tensors.end())
-                tensors.erase(it);
+            compact();
+            return ops;
         }
+        /**
+         * @brief Looks up a tensor by fuid or an operator by guid, nullptr if
+         * it is not in the graph.
+         */
+        Tensor getTensor(int fuid) const;
+        Operator getOperator(UidBaseType guid) const;
 
-        const TensorVec &getTensors() const { return tensors; }
-        const OpVec &getOperators() const { return ops; }
-        Tensor getTensor(int) const;
+        /**
+         * @brief Gets a snapshot of the connectivity of the graph, valid until
+         * the graph changes. Operator and tensor ids are their positions in
+         * `getOperators` and `getTensors`.
+         */
+        const GraphTopology &getTopology() const;
 
         /**
          * @brief Sort the nodes in topological order.
@@ -53,12 +88,137 @@ namespace infini
          */
         bool topo_sort();
 
+        /**
+         * @brief Reorders the operators for a goal, e.g. the order with the
+         * lowest peak of live tensors for a smaller arena, see `scheduleOps`.
+         * `dataMalloc` keeps the order until the graph changes. Returns false
+         * if there are rings in the graph.
+         */
+        bool schedule(ScheduleGoal goal);
+
         void optimize();
 
+        /**
+         * @brief Recomputes cheap intermediate tensors right before their
+         * later consumers instead of keeping them live, until the arena
+         * planned by `dataMalloc` fits in `budget` bytes or no tensor live
+         * across the peak step can be recomputed. At each step the tensor
+         * with the most bytes saved per recomputed element is picked, where
+         * inputs of the recomputation that would be freed before the peak
+         * count against the bytes saved. Fragmentation may keep the arena
+         * from shrinking by the bytes saved. Call `dataMalloc` afterwards.
+         */
+        RematerializationReport rematerialize(size_t budget);
+
         void shape_infer();
 
+        /**
+         * @brief Infers shapes only for the operators that depend on the
+         * `changed` tensors, in topological order.
+         */
+        void shape_infer(const TensorVec &changed);
+
+        /**
+         * @brief Changes the shapes of graph inputs, propagates them through
+         * the affected operators and re-plans memory without rebuilding the
+         * graph. Plans are cached per bucket of tensor sizes, each rounded up
+         * to one of 8 steps per power of two, so shapes falling in a seen
+         * bucket reuse its plan. The arena only grows. Data in the arena,
+         * including inputs, is not preserved.
+         */
+        void reshape(const vector<pair<Tensor, Shape>> &inputShapes);
+
+        /**
+         * @brief Plans the memory of all tensors but weights in one arena,
+         * reusing the memory of intermediate tensors after their last use,
+         * and binds the tensors to it. Workspaces requested by the kernels of
+         * the operators are planned in the arena too, each live only while
+         * its operator runs. Weights not bound to data are placed in the
+         * weight arena instead, see `getWeightArena`. Tensors without a
+         * source that are bound to data outside the arena, and tensors bound
+         * by `bindExternalData`, are left as they are. The plan is kept for
+         * `getMemoryPlan`. It can be called again after shapes change.
+         */
         void dataMalloc();
 
+        /**
+         * @brief Binds the tensors to an arena laid out by `plan` instead of
+         * planning one, e.g. a plan made by `dataMalloc` for the same graph
+         * in an earlier process. Placements are matched by fuid.
+         */
+        void dataMalloc(const MemoryPlan &plan);
+
+        /**
+         * @brief Binds a caller-owned buffer to a graph input or output, so it
+         * is read or written in place instead of copied through the arena.
+         * The buffer must hold `tensor->getBytes()` bytes, be aligned to the
+         * size of the data type and outlive its use by the graph; buffers
+         * aligned like the runtime also get the vectorized kernel paths.
+         * Bound tensors are excluded from the arena by the next `dataMalloc`,
+         * and binding another buffer later only swaps the pointer. Buffers
+         * must be bound again after `reshape`.
+         */
+        void bindExternalData(const Tensor &tensor, void *ptr);
+        bool isExternallyBound(const Tensor &tensor) const
+        {
+            return boundTensors.count(tensor->getFuid()) > 0;
+        }
+
+        /**
+         * @brief Gets the arena holding the weights placed by `dataMalloc`,
+         * nullptr if there is none. It can be sealed read-only once the
+         * weights are written.
+         */
+        const WeightArena &getWeightArena() const { return weightArena; }
+        /**
+         * @brief Binds the weights of this graph to the arena of another
+         * graph with the same weights, e.g. a replica of a model, so only
+         * activations are allocated per graph. Weights bound to data outside
+         * the weight arena of this graph are left as they are.
+         */
+        void setWeightArena(const WeightArena &arena);
+
+        /**
+         * @brief Gets the bytes of workspace the kernels of `op` need, see
+         * `Kernel::getWorkspaceSize`.
+         */
+        size_t getWorkspaceSize(const Operator &op) const;
+        /**
+         * @brief Gets the workspace planned for `op` by `dataMalloc`, in the
+         * arena of the current `ExecutionContext` if there is one, or nullptr
+         * if it needs none.
+         */
+        void *getWorkspace(const Operator &op) const;
+
+        /**
+         * @brief Gets the madvise hints of each step, planned by `dataMalloc`
+         * from the liveness of the placements when the arena is backed by a
+         * spill file (see `NativeCpuRuntimeObj::setSpillDirectory`), or
+         * empty. The inputs of each operator are read ahead while the one
+         * before it runs, and the whole pages of tensors and workspaces are
+         * dropped after their last use, so only the working set of a few
+         * steps stays in memory. Graph inputs and outputs are never dropped.
+         */
+        const vector<PageHints> &getPageHints() const { return pageHints; }
+        /**
+         * @brief Issues the hints of `step` to the arena of the current
+         * `ExecutionContext`, or of the graph, before and after the step
+         * runs. Called by `run`.
+         */
+        void adviseBefore(size_t step) const;
+        void adviseAfter(size_t step) const;
+
+        /**
+         * @brief Gets the plan made by the last `dataMalloc`.
+         */
+        const MemoryPlan &getMemoryPlan() const { return memoryPlan; }
+        /**
+         * @brief Gets the number of plans cached by `reshape`. The cache is
+         * dropped whenever the operators, their connections or the tensors
+         * placed in the arena change.
+         */
+        size_t getPlanCacheSize() const { return planCache.size(); }
+
         /**
          * @brief Add an operator and create its outputs. Output tensor arguments
          * should be empty Refs (e.g., nullptr).
@@ -87,10 +247,11 @@ namespace infini
          */
         inline TensorVec getInputs() const
         {
+            auto &topo = getTopology();
             TensorVec ret;
-            for (const auto &t : tensors)
-                if (!t->getSource())
-                    ret.emplace_back(t);
+            for (size_t i = 0; i < tensors.size(); ++i)
+                if (topo.getSource(i) < 0)
+                    ret.emplace_back(tensors[i]);
             return ret;
         }
 
@@ -99,21 +260,79 @@ namespace infini
          */
         inline TensorVec getOutputs() const
         {
+            auto &topo = getTopology();
             TensorVec ret;
-            for (const auto &t : tensors)
-                if (t->getTargets().empty())
-                    ret.emplace_back(t);
+            for (size_t i = 0; i < tensors.size(); ++i)
+                if (topo.getTargets(i).empty())
+                    ret.emplace_back(tensors[i]);
             return ret;
         }
 
         bool checkValid() const;
 
     private:
+        /**
+         * @brief Drops the tombstones of removed tensors and operators and
+         * updates the indexes, in linear time.
+         */
+        void compact() const;
+        void reindexOperators() const;
+        /**
+         * @brief Puts the operators in `order`, a permutation of their
+         * positions.
+         */
+        void reorderOperators(const vector<int> &order);
+
+        /**
+         * @brief Adds a copy of the source of `tensor` computing it again
+         * right before the first of its targets after `step`, and moves
+         * those targets to the copy. Returns the copy.
+         */
+        Operator recompute(const Tensor &tensor, int step);
+
         /**
          * @brief Add reverse connections and Op relationship in ctor.
          */
         void addOperatorAndConnect(const Operator &op);
 
+        /**
+         * @brief Infers the output shapes of `op` and returns the outputs
+         * whose shapes changed.
+         */
+        TensorVec inferOutputShapes(const Operator &op);
+
+        /**
+         * @brief Plans the arena for the current shapes, with tensor sizes
+         * rounded up by `getBucketBytes` if `bucketed`.
+         */
+        MemoryPlan planMemory(bool bucketed);
+
+        /**
+         * @brief Gets the tensors not to place in the arena: those bound by
+         * `bindExternalData`, and tensors without a source bound to data
+         * outside the arena of the current plan, e.g. memory-mapped weights.
+         */
+        std::unordered_set<TensorObj *> getExternalTensors() const;
+
+        static size_t getBucketBytes(size_t bytes);
+
+        /**
+         * @brief Plans `pageHints` for the arena laid out by `plan`.
+         */
+        void planPageHints(const MemoryPlan &plan);
+
+        /**
+         * @brief Gets the weights that belong in the weight arena: those not
+         * bound to data and those bound to the current arena.
+         */
+        TensorVec getArenaWeights() const;
+
+        // fuids of tensors bound by `bindExternalData`
+        std::unordered_set<UidBaseType> boundTensors;
+
+        // bucketed tensor sizes -> plan, see `reshape`
+        std::map<vector<size_t>, MemoryPlan> planCache;
+
         /**
          * @brief If the nodes is sorted in topological order.
          */
@@ -0,0 +1,59 @@
+#pragma once
+#include "core/graph.h"
+
+namespace infini
+{
+
+    /**
+     * @brief An on-disk cache of compiled graphs keyed by their structure.
+     *
+     * Compiling a graph runs `optimize`, `shape_infer`, `dataMalloc` and
+     * optionally kernel tuning, then stores the optimized graph without
+     * weights, its memory plan and the tuned kernel variants under the cache
+     * directory. When a graph with the same key is compiled again, even in
+     * another process, the stored graph is loaded and bound to the stored
+     * plan without running any pass. Weights are always taken from the graph
+     * being compiled, so graphs differing only in weight data share an entry.
+     * Weights of that graph not bound to data yet, e.g. in a graph built in
+     * code, are bound to the weight arena of the loaded graph, so data set on
+     * them afterwards reaches it.
+     */
+    class GraphCache
+    {
+    private:
+        string dir;
+        int hits = 0, misses = 0;
+
+    public:
+        explicit GraphCache(string dir);
+
+        /**
+         * @brief Gets the cache key of a graph: its `hashGraph` combined with
+         * the device and the cache format version.
+         */
+        static uint64_t getKey(const Graph &graph);
+
+        /**
+         * @brief Returns a graph ready to run. On a hit this is a new graph
+         * sharing the weights of `graph`; on a miss `graph` itself is compiled
+         * in place and stored. A stored entry that can not be loaded is
+         * treated as a miss and overwritten.
+         *
+         * @param tune Whether to tune kernels on a miss, see
+         * `RuntimeObj::tune`.
+         */
+        Graph compile(const Graph &graph, bool tune = false);
+
+        bool contains(uint64_t key) const;
+        int getHits() const { return hits; }
+        int getMisses() const { return misses; }
+
+    private:
+        string getPath(uint64_t key, const string &ext) const;
+        void store(uint64_t key, const Graph &compiled,
+                   const std::unordered_map<TensorObj *, size_t> &sourceIndex,
+                   bool tuned) const;
+        Graph load(uint64_t key, const Graph &source) const;
+    };
+
+} // namespace infini
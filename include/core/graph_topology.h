@@ -0,0 +1,100 @@
+#pragma once
+#include "core/operator.h"
+#include <unordered_map>
+
+namespace infini
+{
+
+    /**
+     * @brief A read-only snapshot of the connectivity of a graph for passes
+     * that traverse it.
+     *
+     * Operators and tensors are numbered by their position in the graph and
+     * all edges are kept in a few flat arrays in CSR form, so traversals do
+     * not allocate or touch the reference counts of `WRef` edges. Edges are
+     * derived from the inputs and outputs of the operators. The snapshot
+     * refers to the objects of the graph without owning them and is rebuilt
+     * by `GraphObj::getTopology` after the graph changes.
+     */
+    class GraphTopology
+    {
+    public:
+        // a contiguous range of ids
+        struct Range
+        {
+            const int *first, *last;
+            const int *begin() const { return first; }
+            const int *end() const { return last; }
+            size_t size() const { return last - first; }
+            bool empty() const { return first == last; }
+        };
+
+    private:
+        vector<OperatorObj *> ops;
+        vector<TensorObj *> tensors;
+        std::unordered_map<const TensorObj *, int> tensorIds;
+        // CSR arrays: the edges of node i are ids[offsets[i], offsets[i+1])
+        vector<int> inputOffsets, inputIds;
+        vector<int> outputOffsets, outputIds;
+        vector<int> targetOffsets, targetIds;
+        vector<int> predOffsets, predIds;
+        vector<int> succOffsets, succIds;
+        // tensor -> producing operator, -1 if none in the graph
+        vector<int> sources;
+
+    public:
+        GraphTopology(const OpVec &ops, const TensorVec &tensors);
+
+        int getOpCount() const { return ops.size(); }
+        int getTensorCount() const { return tensors.size(); }
+        OperatorObj *getOp(int op) const { return ops[op]; }
+        TensorObj *getTensor(int tensor) const { return tensors[tensor]; }
+        /**
+         * @brief Gets the id of a tensor, -1 if it is not in the graph.
+         */
+        int getTensorId(const TensorObj *tensor) const;
+
+        Range getInputs(int op) const
+        {
+            return range(inputOffsets, inputIds, op);
+        }
+        Range getOutputs(int op) const
+        {
+            return range(outputOffsets, outputIds, op);
+        }
+        Range getPredecessors(int op) const
+        {
+            return range(predOffsets, predIds, op);
+        }
+        Range getSuccessors(int op) const
+        {
+            return range(succOffsets, succIds, op);
+        }
+        Range getTargets(int tensor) const
+        {
+            return range(targetOffsets, targetIds, tensor);
+        }
+        int getSource(int tensor) const { return sources[tensor]; }
+
+        /**
+         * @brief Gets the operators in topological order, preferring lower
+         * ids among ready ones, so a sorted graph keeps its order. The result
+         * is shorter than the number of operators if there is a cycle.
+         */
+        vector<int> topoOrder() const;
+
+        /**
+         * @brief Gets the id of the last operator reading each tensor, -1 for
+         * tensors that are not read. Ids are steps if the graph is sorted.
+         */
+        vector<int> lastUses() const;
+
+    private:
+        static Range range(const vector<int> &offsets, const vector<int> &ids,
+                           int i)
+        {
+            return {ids.data() + offsets[i], ids.data() + offsets[i + 1]};
+        }
+    };
+
+} // namespace infini
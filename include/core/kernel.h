@@ -3,6 +3,7 @@
 #include "core/operator.h"
 #include "core/tensor.h"
 #include "utils/operator_utils.h"
+#include <cstddef>
 #include <functional>
 
 namespace infini
@@ -17,10 +18,33 @@ namespace infini
         virtual ~Kernel() {}
 
         /**
-         * @brief Executes an op with a default parameter.
+         * @brief Gets the bytes of scratch memory `compute` needs for an op,
+         * e.g. for packing an operand. `GraphObj::dataMalloc` plans the
+         * workspace in the arena, live only while the op runs, so kernels do
+         * not allocate during `run`.
          */
-        virtual void compute(const Operator &op,
+        virtual size_t getWorkspaceSize(const Operator &op) const { return 0; }
+
+        /**
+         * @brief Executes an op with a default parameter. `workspace` holds
+         * `getWorkspaceSize(op)` bytes aligned like the runtime, or is
+         * nullptr if no bytes were requested.
+         */
+        virtual void compute(const Operator &op, void *workspace,
                              const RuntimeObj *context) const = 0;
+
+        /**
+         * @brief Executes an op outside a planned graph, allocating its
+         * workspace, e.g. in tests.
+         */
+        void compute(const Operator &op, const RuntimeObj *context) const
+        {
+            size_t bytes = getWorkspaceSize(op);
+            vector<std::max_align_t> workspace(
+                (bytes + sizeof(std::max_align_t) - 1) /
+                sizeof(std::max_align_t));
+            compute(op, bytes > 0 ? workspace.data() : nullptr, context);
+        }
     };
 
     class KernelRegistry
@@ -30,14 +54,18 @@ namespace infini
             tuple<Kernel *const, const string, const int>; // Kernel, name, ID
 
     private:
-        std::map<KernelAttrs, KernelRecord> kernels;
+        // Several implementations (variants) may be registered for one key.
+        // The first one registered is the default and is used unless a
+        // tuner selects another one.
+        std::map<KernelAttrs, vector<KernelRecord>> kernels;
         int nKernels = 0;
 
     public:
         ~KernelRegistry()
         {
             for (auto &[k, v] : kernels)
-                delete std::get<0>(v);
+                for (auto &record : v)
+                    delete std::get<0>(record);
         }
         static KernelRegistry &getInstance()
         {
@@ -46,29 +74,65 @@ namespace infini
         }
         bool registerKernel(const KernelAttrs &key, Kernel *kernel, string name)
         {
-            IT_ASSERT(kernels.find(key) == kernels.end(),
-                      "Kernel already registered");
-            kernels.emplace(key, KernelRecord{kernel, name, ++nKernels});
+            auto &variants = kernels[key];
+            for (auto &record : variants)
+                IT_ASSERT(std::get<1>(record) != name,
+                          "Kernel already registered: " + name);
+            variants.emplace_back(kernel, name, ++nKernels);
             return true;
         }
         Kernel *getKernel(const KernelAttrs &kernelAttrs) const
+        {
+            return std::get<0>(getKernelItem(kernelAttrs));
+        }
+        const KernelRecord &getKernelItem(const KernelAttrs &kernelAttrs) const
+        {
+            return getKernelItems(kernelAttrs).front();
+        }
+        /**
+         * @brief Gets the variant registered under `name`, or nullptr if there
+         * is no such variant for this key.
+         */
+        const KernelRecord *getKernelItem(const KernelAttrs &kernelAttrs,
+                                          const string &name) const
+        {
+            for (auto &record : getKernelItems(kernelAttrs))
+                if (std::get<1>(record) == name)
+                    return &record;
+            return nullptr;
+        }
+        /**
+         * @brief Gets the largest workspace any variant needs for `op`, since
+         * the variant to run may be selected after memory is planned, or 0
+         * if no kernel is registered for it.
+         */
+        size_t getWorkspaceSize(const KernelAttrs &kernelAttrs,
+                                const Operator &op) const
+        {
+            auto it = kernels.find(kernelAttrs);
+            size_t bytes = 0;
+            if (it != kernels.end())
+                for (auto &record : it->second)
+                    bytes = std::max(bytes,
+                                     std::get<0>(record)->getWorkspaceSize(op));
+            return bytes;
+        }
+        const vector<KernelRecord> &
+        getKernelItems(const KernelAttrs &kernelAttrs) const
         {
             auto it = kernels.find(kernelAttrs);
             IT_ASSERT(it != kernels.end(), "Kernel not found for key {" +
                                                get_kernel_attrs_str(kernelAttrs) +
                                                "}");
-            return std::get<0>(it->second);
-        }
-        const KernelRecord &getKernelItem(const KernelAttrs &kernelAttrs) const
-        {
-            return kernels.at(kernelAttrs);
+            return it->second;
         }
     };
 
     class CpuKernelWithoutConfig : public Kernel
     {
     public:
-        virtual void compute(const Operator &op,
+        using Kernel::compute;
+        virtual void compute(const Operator &op, void *workspace,
                              const RuntimeObj *context) const = 0;
     };
 
@@ -0,0 +1,114 @@
+#pragma once
+#include "core/object.h"
+
+namespace infini
+{
+
+    // fuid of the placements of operator workspaces
+    constexpr UidBaseType kWorkspaceFuid = -1;
+
+    /**
+     * @brief Placement of one tensor in the arena planned by
+     * `GraphObj::dataMalloc`. Steps are indices of operators in topological
+     * order; a tensor is live in [firstUse, lastUse], both inclusive. The
+     * workspace of an operator (see `Kernel::getWorkspaceSize`) is placed
+     * like a tensor live only at its step, with fuid `kWorkspaceFuid` and the
+     * guid of the operator.
+     */
+    struct TensorPlacement
+    {
+        UidBaseType fuid;
+        UidBaseType guid;
+        size_t offset;
+        size_t bytes;
+        int firstUse;
+        int lastUse;
+        string producer; // "input" for tensors without a source operator
+
+        bool isWorkspace() const { return fuid == kWorkspaceFuid; }
+    };
+
+    /**
+     * @brief Page-aligned ranges (offset, bytes) of an arena to advise the
+     * kernel about around one step, see `GraphObj::getPageHints`.
+     */
+    struct PageHints
+    {
+        // read by the operator of the next step, or of this one at step 0;
+        // read ahead before the step runs
+        vector<pair<size_t, size_t>> willNeed;
+        // dead after the step; dropped once it ran
+        vector<pair<size_t, size_t>> dontNeed;
+    };
+
+    /**
+     * @brief The memory plan of a graph and its fragmentation metrics.
+     */
+    class MemoryPlan
+    {
+    private:
+        vector<TensorPlacement> placements;
+        int steps = 0;
+        size_t peak = 0;
+
+    public:
+        MemoryPlan() = default;
+        MemoryPlan(int steps) : steps(steps) {}
+
+        void add(TensorPlacement placement)
+        {
+            placements.emplace_back(std::move(placement));
+        }
+        void setPeak(size_t peak) { this->peak = peak; }
+
+        const vector<TensorPlacement> &getPlacements() const
+        {
+            return placements;
+        }
+        int getSteps() const { return steps; }
+        /**
+         * @brief Gets the arena size, i.e. the allocator peak.
+         */
+        size_t getPeak() const { return peak; }
+
+        /**
+         * @brief Gets the bytes of live tensors at each step.
+         */
+        vector<size_t> getLiveBytes() const;
+        /**
+         * @brief Gets the largest sum of bytes of tensors live at the same
+         * step, a lower bound of the arena size for this operator order.
+         */
+        size_t getLowerBound() const;
+        /**
+         * @brief Gets the step at which the end of the highest live block is
+         * the highest.
+         */
+        int getPeakStep() const;
+        /**
+         * @brief Gets the bytes not covered by live tensors below the highest
+         * live block at the peak step, including alignment padding.
+         */
+        size_t getWastedAtPeak() const;
+        /**
+         * @brief Gets the tensors live at the peak step, largest first.
+         */
+        vector<TensorPlacement> getPeakTensors() const;
+
+        string summary() const;
+        void print() const { std::cout << summary(); }
+        /**
+         * @brief Exports the plan and its metrics as JSON. Every placement is a
+         * rectangle [firstUse, lastUse + 1) x [offset, offset + bytes) of a
+         * time x address chart.
+         */
+        string toJson() const;
+        /**
+         * @brief Exports one line per placement with a header line.
+         */
+        string toCsv() const;
+        void exportJson(const string &path) const;
+        void exportCsv(const string &path) const;
+    };
+
+} // namespace infini
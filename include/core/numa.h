@@ -0,0 +1,72 @@
+#pragma once
+#include "core/common.h"
+
+namespace infini
+{
+
+    /**
+     * @brief How the threads running kernels are pinned to CPUs.
+     */
+    enum class Affinity
+    {
+        None,    // threads float freely
+        Compact, // fill the CPUs of one node before the next
+        Scatter  // spread consecutive threads over the nodes
+    };
+
+    struct NumaNode
+    {
+        int id;
+        vector<int> cpus;
+    };
+
+    /**
+     * @brief The NUMA nodes of the machine and their CPUs, read from
+     * /sys/devices/system/node. Without NUMA information all online CPUs
+     * form node 0.
+     */
+    class NumaTopology
+    {
+    private:
+        vector<NumaNode> nodes;
+
+    public:
+        explicit NumaTopology(vector<NumaNode> nodes);
+
+        /**
+         * @brief Gets the topology of this machine, detected once.
+         */
+        static const NumaTopology &get();
+
+        const vector<NumaNode> &getNodes() const { return nodes; }
+        int getNodeCount() const { return nodes.size(); }
+
+        /**
+         * @brief Gets the CPUs for consecutive threads under `affinity`,
+         * restricted to one node if `node` is not negative. Empty for
+         * `Affinity::None`.
+         */
+        vector<int> getCpus(Affinity affinity, int node = -1) const;
+
+        string toString() const;
+
+        /**
+         * @brief Parses a kernel CPU list such as "0-3,8,10-11".
+         */
+        static vector<int> parseCpuList(const string &list);
+    };
+
+    /**
+     * @brief Restricts the calling thread to a set of CPUs. Returns false on
+     * failure.
+     */
+    bool pinThread(const vector<int> &cpus);
+
+    /**
+     * @brief Binds the pages of [ptr, ptr + size) to a NUMA node with mbind,
+     * so they are placed there when first touched. `ptr` must be page
+     * aligned. Returns false if the kernel does not support it.
+     */
+    bool bindMemory(void *ptr, size_t size, int node);
+
+} // namespace infini
@@ -0,0 +1,23 @@
+#pragma once
+#include "core/graph.h"
+
+namespace infini
+{
+
+    /**
+     * @brief Imports an ONNX model into a new graph.
+     *
+     * Supported operators are MatMul, Gemm (alpha = beta = 1, with transA and
+     * transB), Transpose, Concat, Add, Sub, Mul, Div, Relu, Clip and Cast.
+     * Graph inputs become `Input` tensors and initializers used by operators
+     * become weights, copied into one buffer owned by the graph; initializers
+     * stored as external data are streamed from their files into it. Clip
+     * bounds given as inputs must be initializers.
+     *
+     * @param inputShapes Shapes of graph inputs, required for inputs with
+     * symbolic dims and overriding the shapes in the model otherwise.
+     */
+    Graph importOnnx(const string &path, Runtime runtime,
+                     const std::map<string, Shape> &inputShapes = {});
+
+} // namespace infini
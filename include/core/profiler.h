@@ -0,0 +1,109 @@
+#pragma once
+#include "core/object.h"
+#include "core/op_type.h"
+#include "core/runtime.h"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace infini
+{
+
+    /**
+     * @brief Measurement of one operator execution.
+     */
+    struct OpProfile
+    {
+        UidBaseType guid;
+        OpType type;
+        string kernel;
+        double begin;    // us since the profiler was created
+        double duration; // us
+        size_t bytesRead;
+        size_t bytesWritten;
+        double flops; // 0 if the operator has no FLOP model
+        int thread;   // index of the recording thread, by first record
+    };
+
+    /**
+     * @brief Sum of the profiles of all operators of one OpType.
+     */
+    struct OpTypeProfile
+    {
+        OpType type = OpType::Unknown;
+        size_t count = 0;
+        double duration = 0; // us
+        size_t bytes = 0;
+        double flops = 0;
+    };
+
+    /**
+     * @brief Collects per-operator measurements while profiling is enabled on
+     * a runtime. Records of consecutive runs are accumulated until `clear`.
+     */
+    class Profiler
+    {
+    private:
+        using clock = std::chrono::steady_clock;
+        clock::time_point origin = clock::now();
+        vector<OpProfile> records;
+        std::map<std::thread::id, int> threads;
+        // execution contexts may run concurrently
+        mutable std::mutex mutex;
+
+        static vector<OpTypeProfile>
+        aggregate(const vector<OpProfile> &records);
+
+    public:
+        /**
+         * @brief Gets the timestamp in us that `record` expects.
+         */
+        double now() const
+        {
+            return std::chrono::duration<double, std::micro>(clock::now() -
+                                                             origin)
+                .count();
+        }
+        void record(const Operator &op, const string &kernel, double begin,
+                    double end);
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            records.clear();
+            threads.clear();
+        }
+
+        /**
+         * @brief Gets a copy of the records, safe while other threads record.
+         */
+        vector<OpProfile> getRecords() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return records;
+        }
+        /**
+         * @brief Aggregates the records per OpType, sorted by total time in
+         * descending order.
+         */
+        vector<OpTypeProfile> aggregate() const
+        {
+            return aggregate(getRecords());
+        }
+
+        /**
+         * @brief Gets the FLOP count of an operator. Only MatMul has a FLOP
+         * model (2 * m * n * k per batch); other operators return 0.
+         */
+        static double getFlops(const Operator &op);
+
+        string summary() const;
+        void printSummary() const { std::cout << summary(); }
+        /**
+         * @brief Exports the records in Chrome trace-event JSON format, which
+         * can be opened by chrome://tracing or Perfetto.
+         */
+        void exportChromeTrace(const string &path) const;
+    };
+
+} // namespace infini
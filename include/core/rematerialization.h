@@ -0,0 +1,33 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+
+    /**
+     * @brief Gets the cost of computing the outputs of `op` again, in element
+     * operations, or 0 if it is not cheap enough to recompute. Only
+     * element-wise operators, Transpose and Cast are.
+     */
+    size_t getRecomputeCost(const Operator &op);
+
+    /**
+     * @brief The trade-off chosen by `GraphObj::rematerialize`.
+     */
+    struct RematerializationReport
+    {
+        size_t budget = 0;
+        // arena sizes before and after the pass
+        size_t peakBefore = 0, peakAfter = 0;
+        // operators added to recompute tensors and their total cost, see
+        // `getRecomputeCost`
+        int recomputed = 0;
+        size_t extraCost = 0;
+        // one line per recomputed tensor
+        vector<string> decisions;
+
+        bool fits() const { return peakAfter <= budget; }
+        string toString() const;
+    };
+
+} // namespace infini
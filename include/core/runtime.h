@@ -1,7 +1,12 @@
 #pragma once
 #include "core/common.h"
+#include "core/numa.h"
 #include "core/op_type.h"
 #include "core/ref.h"
+#include "core/thread_pool.h"
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
 
 namespace infini
 {
@@ -10,6 +15,8 @@ namespace infini
   class GraphObj;
   class RuntimeObj;
   class BlobObj;
+  class KernelTuner;
+  class Profiler;
 
   using Tensor = Ref<TensorObj>;
   using Operator = Ref<OperatorObj>;
@@ -29,6 +36,19 @@ namespace infini
   {
   protected:
     Device device;
+    // Created on first use; without it every operator runs its default kernel.
+    Ref<KernelTuner> tuner;
+    // Non-null while profiling is enabled.
+    Ref<Profiler> profiler;
+    // Alignment of allocations and of tensors placed in arenas, in bytes.
+    size_t alignment = 64;
+    // Runs the loops of kernels. Created on first use with `defaultThreads`
+    // threads unless set.
+    mutable Ref<ThreadPool> threadPool;
+    mutable std::mutex threadPoolMutex;
+    int defaultThreads = 0;
+    // CPUs the threads of the pool are pinned to, see `ThreadPool`.
+    vector<vector<int>> threadCpus;
 
   public:
     explicit RuntimeObj(Device device)
@@ -45,14 +65,78 @@ namespace infini
     {
       return true;
     }
+    Device getDevice() const { return device; }
+
+    /**
+     * @brief Sets the alignment of memory returned by `alloc` and of tensors
+     * placed by graphs created afterwards. It must be a power of two and at
+     * least `sizeof(void *)`.
+     */
+    void setAlignment(size_t alignment);
+    size_t getAlignment() const { return alignment; }
+
+    /**
+     * @brief Replaces the thread pool with one of `threads` threads,
+     * including the thread calling `run`. 0 means one per CPU.
+     */
+    void setThreadCount(int threads);
+    /**
+     * @brief Makes kernels use a pool shared with other runtimes or with the
+     * application.
+     */
+    void setThreadPool(Ref<ThreadPool> pool);
+    ThreadPool &getThreadPool() const;
+    int getThreadCount() const { return getThreadPool().getThreadCount(); }
+    /**
+     * @brief Runs a kernel loop on the thread pool, see
+     * `ThreadPool::parallel_for`. Kernels get tensor data pointers before
+     * calling it, since tensor data of an `ExecutionContext` only resolves on
+     * the calling thread.
+     */
+    void parallel_for(size_t begin, size_t end, size_t grain,
+                      const ThreadPool::Task &task) const
+    {
+      getThreadPool().parallel_for(begin, end, grain, task);
+    }
+
+    KernelTuner &getTuner();
+    bool hasTuner() const { return tuner != nullptr; }
+    /**
+     * @brief Measures all registered kernel variants of the operators in an
+     * allocated graph and makes `run` use the fastest ones.
+     */
+    void tune(const Graph &graph);
+
+    /**
+     * @brief Makes `run` record every operator execution. Disabling it drops
+     * the collected records.
+     */
+    void setProfiling(bool enable);
+    bool isProfiling() const { return profiler != nullptr; }
+    Profiler &getProfiler();
 
     virtual string toString() const = 0;
+
+  protected:
+    void setThreadCpus(vector<vector<int>> cpus);
   };
 
   class NativeCpuRuntimeObj : public RuntimeObj
   {
+  private:
+    // NUMA node the arenas and threads of this runtime stay on, or -1.
+    int numaNode;
+    Affinity affinity = Affinity::None;
+    // Bumped by `setAffinity`, so threads pin themselves again.
+    std::atomic<unsigned> affinityEpoch{0};
+    string spillDirectory;
+    size_t spillThreshold = 0;
+    // file-backed blocks returned by `alloc` -> their mapped bytes
+    mutable std::mutex spillMutex;
+    std::unordered_map<void *, size_t> spilled;
+
   public:
-    NativeCpuRuntimeObj() : RuntimeObj(Device::CPU) {}
+    explicit NativeCpuRuntimeObj(int numaNode = -1);
 
     static Ref<NativeCpuRuntimeObj> &getInstance()
     {
@@ -60,10 +144,64 @@ namespace infini
           make_ref<NativeCpuRuntimeObj>();
       return instance;
     }
+    /**
+     * @brief Gets the runtime of one NUMA node. Its allocations are bound to
+     * the node, and its thread pool has one thread per CPU of the node and
+     * stays on them.
+     */
+    static Ref<NativeCpuRuntimeObj> getInstance(int numaNode);
+
+    int getNumaNode() const { return numaNode; }
+    /**
+     * @brief Pins the threads of the thread pool to CPUs, the i-th thread to
+     * the i-th CPU of `NumaTopology::getCpus`. The thread calling `run`, the
+     * first one, is kept on the CPUs of all threads, so concurrent callers
+     * do not share one CPU. With `Affinity::None` all threads may run on any
+     * CPU of the node, or of the machine, undoing an earlier pinning.
+     */
+    void setAffinity(Affinity affinity);
+    Affinity getAffinity() const { return affinity; }
+    /**
+     * @brief Describes the topology, the node and the CPUs this runtime
+     * uses.
+     */
+    string getTopologyReport() const;
+
+    /**
+     * @brief Backs blocks of at least `threshold` bytes returned by `alloc`,
+     * e.g. the arenas of graphs, and the weight arenas of graphs with memory-
+     * mapped files in `directory` instead of anonymous memory, so graphs
+     * larger than RAM run with their pages written to and read back from
+     * disk by the kernel. Graphs planned on a spilled arena advise the
+     * kernel which pages to read ahead and drop at each step, see
+     * `GraphObj::getPageHints`. The files are unlinked once mapped. An empty
+     * directory turns spilling off; blocks allocated before keep their
+     * backing.
+     */
+    void setSpillDirectory(const string &directory, size_t threshold = 0);
+    const string &getSpillDirectory() const { return spillDirectory; }
+    bool shouldSpill(size_t bytes) const
+    {
+      return !spillDirectory.empty() && bytes >= spillThreshold;
+    }
+    /**
+     * @brief Checks whether `ptr` is a block returned by `alloc` and backed
+     * by a spill file.
+     */
+    bool isSpilled(const void *ptr) const;
+    /**
+     * @brief Maps a new spill file of `bytes` bytes, a multiple of the page
+     * size, shared and writable. The caller unmaps it.
+     */
+    void *mapSpillFile(size_t bytes) const;
+
     void dealloc(void *ptr) override;
     void run(const Graph &graph) const override;
     void *alloc(size_t size) override;
     string toString() const override;
+
+  private:
+    void pinThreads() const;
   };
 
 } // namespace infini
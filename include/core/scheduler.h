@@ -0,0 +1,49 @@
+#pragma once
+#include "core/graph_topology.h"
+
+namespace infini
+{
+
+    enum class ScheduleGoal
+    {
+        // keep the order of `GraphTopology::topoOrder`
+        Default,
+        // lowest peak of live tensor bytes
+        MinMemory,
+        // operators grouped by depth, so independent ones are adjacent
+        MaxParallelism,
+    };
+
+    /**
+     * @brief Picks a topological order of the operators of `topo` for a goal.
+     *
+     * For `MinMemory`, a tensor is live from the step of its source to the
+     * step of its last target, or to the end if it has none, like in
+     * `GraphObj::dataMalloc`; `bytes` gives the size of each tensor, 0 for
+     * tensors not planned per step, e.g. graph inputs. Graphs of at most
+     * `kExactScheduleOps` operators are scheduled optimally by a dynamic
+     * program over the sets of executed operators, unless it visits more
+     * than `kExactScheduleStates` sets; larger graphs greedily run the ready
+     * operator that grows the live bytes the least.
+     *
+     * For `MaxParallelism`, operators are ordered by the length of the
+     * longest path reaching them, so each group of the same depth has no
+     * dependencies within it and could run concurrently.
+     *
+     * The greedy and depth orders break ties by lower ids. The result is
+     * shorter than the number of operators if there is a cycle.
+     */
+    vector<int> scheduleOps(const GraphTopology &topo, ScheduleGoal goal,
+                            const vector<size_t> &bytes);
+
+    /**
+     * @brief Gets the peak of live tensor bytes when running the operators
+     * of `topo` in `order`, with the liveness used by `scheduleOps`.
+     */
+    size_t getPeakLiveBytes(const GraphTopology &topo, const vector<int> &order,
+                            const vector<size_t> &bytes);
+
+    constexpr int kExactScheduleOps = 20;
+    constexpr size_t kExactScheduleStates = 1 << 16;
+
+} // namespace infini
@@ -0,0 +1,47 @@
+#pragma once
+#include "core/graph.h"
+
+namespace infini
+{
+
+    /**
+     * @brief Saves a graph in the InfiniTensor binary format.
+     *
+     * The file starts with a fixed header, followed by tensor metadata,
+     * operators in topological order with their attributes, and finally the
+     * data of weight tensors (see `TensorObj::setWeight`), each starting at a
+     * multiple of `kWeightAlignment` bytes from the start of the file. Weights
+     * that are not bound to data, or all weights if `withWeights` is false,
+     * are saved without it.
+     */
+    void saveGraph(const Graph &graph, const string &path,
+                   bool withWeights = true);
+
+    /**
+     * @brief Loads a graph saved by `saveGraph`.
+     *
+     * The file is memory-mapped read-only and weight tensors are bound to
+     * their data in the mapping without copying, so `dataMalloc` leaves them
+     * out of the arena. The mapping lives as long as any of these tensors'
+     * blobs, and processes loading the same file share its pages. Weights
+     * must not be written to.
+     */
+    Graph loadGraph(const string &path, Runtime runtime);
+
+    /**
+     * @brief Hashes the structure of a graph: tensor dtypes, shapes and types,
+     * and operators with their attributes and connections, in topological
+     * order. Weight data is not hashed.
+     */
+    uint64_t hashGraph(const Graph &graph);
+
+    /**
+     * @brief Encodes the attributes of an operator like `saveGraph`, as hex
+     * digits, e.g. to tell apart operators with the same inputs. Empty for
+     * operators without attributes.
+     */
+    string encodeAttrs(const Operator &op);
+
+    constexpr size_t kWeightAlignment = 64;
+
+} // namespace infini
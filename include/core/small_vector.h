@@ -0,0 +1,195 @@
+#pragma once
+#include "core/common.h"
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+
+namespace infini
+{
+
+    /**
+     * @brief A vector of at most `N` trivially copyable elements stored
+     * inline, so creating and copying one never allocates. It has the subset
+     * of the `std::vector` interface used for shapes; growing past `N`
+     * elements throws.
+     */
+    template <typename T, size_t N>
+    class SmallVector
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T &;
+        using const_reference = const T &;
+        using pointer = T *;
+        using const_pointer = const T *;
+        using iterator = T *;
+        using const_iterator = const T *;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    private:
+        T elems[N] = {};
+        size_t count = 0;
+
+    public:
+        SmallVector() = default;
+        explicit SmallVector(size_t n, const T &val = T()) { assign(n, val); }
+        SmallVector(std::initializer_list<T> list)
+        {
+            assign(list.begin(), list.end());
+        }
+        template <typename It,
+                  typename = std::enable_if_t<!std::is_integral_v<It>>>
+        SmallVector(It first, It last)
+        {
+            assign(first, last);
+        }
+        SmallVector(const vector<T> &vec) { assign(vec.begin(), vec.end()); }
+
+        // for interfaces taking vectors, e.g. permutations given as shapes
+        operator vector<T>() const { return vector<T>(begin(), end()); }
+
+        static constexpr size_t capacity() { return N; }
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+
+        T *data() { return elems; }
+        const T *data() const { return elems; }
+        iterator begin() { return elems; }
+        iterator end() { return elems + count; }
+        const_iterator begin() const { return elems; }
+        const_iterator end() const { return elems + count; }
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        reverse_iterator rend() { return reverse_iterator(begin()); }
+        const_reverse_iterator rbegin() const
+        {
+            return const_reverse_iterator(end());
+        }
+        const_reverse_iterator rend() const
+        {
+            return const_reverse_iterator(begin());
+        }
+
+        T &operator[](size_t i) { return elems[i]; }
+        const T &operator[](size_t i) const { return elems[i]; }
+        T &at(size_t i)
+        {
+            IT_ASSERT(i < count, "Index exceeded");
+            return elems[i];
+        }
+        const T &at(size_t i) const
+        {
+            IT_ASSERT(i < count, "Index exceeded");
+            return elems[i];
+        }
+        T &front() { return elems[0]; }
+        const T &front() const { return elems[0]; }
+        T &back() { return elems[count - 1]; }
+        const T &back() const { return elems[count - 1]; }
+
+        void assign(size_t n, const T &val)
+        {
+            reserve(n);
+            std::fill_n(elems, n, val);
+            count = n;
+        }
+        template <typename It,
+                  typename = std::enable_if_t<!std::is_integral_v<It>>>
+        void assign(It first, It last)
+        {
+            auto n = std::distance(first, last);
+            reserve(n);
+            std::copy(first, last, elems);
+            count = n;
+        }
+        void resize(size_t n, const T &val = T())
+        {
+            reserve(n);
+            if (n > count)
+                std::fill(elems + count, elems + n, val);
+            count = n;
+        }
+        void clear() { count = 0; }
+        void push_back(const T &val)
+        {
+            reserve(count + 1);
+            elems[count++] = val;
+        }
+        template <typename... Args>
+        T &emplace_back(Args &&...args)
+        {
+            reserve(count + 1);
+            return elems[count++] = T(std::forward<Args>(args)...);
+        }
+        void pop_back() { --count; }
+        iterator insert(const_iterator pos, const T &val)
+        {
+            // `val` may be an element shifted by the insertion
+            T copy = val;
+            return insert(pos, &copy, &copy + 1);
+        }
+        template <typename It,
+                  typename = std::enable_if_t<!std::is_integral_v<It>>>
+        iterator insert(const_iterator pos, It first, It last)
+        {
+            size_t at = pos - elems, n = std::distance(first, last);
+            reserve(count + n);
+            std::copy_backward(elems + at, elems + count, elems + count + n);
+            std::copy(first, last, elems + at);
+            count += n;
+            return elems + at;
+        }
+        iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            size_t at = first - elems, n = last - first;
+            std::copy(elems + at + n, elems + count, elems + at);
+            count -= n;
+            return elems + at;
+        }
+        /**
+         * @brief Checks that `n` elements fit; the storage never grows.
+         */
+        void reserve(size_t n) const
+        {
+            if (n > N)
+                overflow(n);
+        }
+
+    private:
+        [[noreturn]] static void overflow(size_t n)
+        {
+            IT_TODO_HALT_MSG("At most " + std::to_string(N) +
+                             " elements are supported, got " +
+                             std::to_string(n));
+        }
+
+    public:
+
+        friend bool operator==(const SmallVector &a, const SmallVector &b)
+        {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end());
+        }
+        friend bool operator!=(const SmallVector &a, const SmallVector &b)
+        {
+            return !(a == b);
+        }
+        friend bool operator<(const SmallVector &a, const SmallVector &b)
+        {
+            return std::lexicographical_compare(a.begin(), a.end(), b.begin(),
+                                                b.end());
+        }
+    };
+
+    template <typename T, size_t N>
+    std::string vecToString(const SmallVector<T, N> &vec)
+    {
+        return vecToString(vec.data(), vec.size());
+    }
+
+} // namespace infini
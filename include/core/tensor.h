@@ -3,6 +3,7 @@
 #include "core/data_type.h"
 #include "core/object.h"
 #include "core/runtime.h"
+#include "core/small_vector.h"
 #include <cmath>
 #include <cstring>
 #include <fstream>
@@ -10,8 +11,29 @@
 namespace infini
 {
     class GraphObj;
+    class ExecutionContext;
+    // The context whose arena tensor data resolves to on this thread, see
+    // `ExecutionContext::Scope`.
+    extern thread_local const ExecutionContext *currentExecutionContext;
+    void *getExecutionContextPtr(const ExecutionContext *context,
+                                 UidBaseType fuid);
+
     using ShapeElem = int;
-    using Shape = vector<ShapeElem>;
+    // Shapes are stored inline, so shape math does not allocate.
+    constexpr size_t kMaxRank = 8;
+    using Shape = SmallVector<ShapeElem, kMaxRank>;
+    // Element counts, strides and offsets are 64-bit, since a tensor may have
+    // more than 2^31 elements even though each dim fits in a ShapeElem.
+    using StrideElem = int64_t;
+    using Stride = SmallVector<StrideElem, kMaxRank>;
+
+    enum class TensorType
+    {
+        Input,       // fed by the caller before each run
+        Initialized, // weights and other constants
+        Other
+    };
+
     class TensorObj : public Object
     {
         friend class GraphObj;
@@ -20,6 +42,7 @@ namespace infini
         int dim;
 
         DataType dtype;
+        TensorType tensorType = TensorType::Other;
         vector<WRef<OperatorObj>> targets;
         WRef<OperatorObj> source;
         Blob data;
@@ -39,7 +62,7 @@ namespace infini
         size_t size() const { return _size; }
         size_t getBytes() const { return _size * dtype.getSize(); }
 
-        Shape getDims() const { return shape; }
+        const Shape &getDims() const { return shape; }
         void setShape(Shape shape_);
         size_t getRank() const { return shape.size(); }
         UidBaseType getFuid() const { return fuid; }
@@ -48,6 +71,15 @@ namespace infini
             std::function<void(void *, size_t, DataType)> const &generator) const;
 
         void setDataBlob(const Blob &blob);
+        Blob getDataBlob() const { return data; }
+        bool hasData() const { return data != nullptr; }
+
+        TensorType getTensorType() const { return tensorType; }
+        void setTensorType(TensorType type) { tensorType = type; }
+        void setWeight() { tensorType = TensorType::Initialized; }
+        void setInput() { tensorType = TensorType::Input; }
+        bool isWeight() const { return tensorType == TensorType::Initialized; }
+        bool isInput() const { return tensorType == TensorType::Input; }
 
         void printData() const;
         bool equalData(const Tensor &rhs, double relativeError = 1e-6) const;
@@ -65,6 +97,10 @@ namespace infini
         {
             static_assert(std::is_pointer_v<T>,
                           "Raw data pointer has a type of pointer");
+            if (currentExecutionContext)
+                if (auto ptr = getExecutionContextPtr(currentExecutionContext,
+                                                      fuid))
+                    return reinterpret_cast<T>(ptr);
             IT_ASSERT(data != nullptr);
             return data->getPtr<T>();
         }
@@ -83,7 +119,7 @@ namespace infini
             builder << "Tensor: " << guid << std::endl;
 
             auto numDims = shape.size();
-            auto dimSzVec = vector<int>(numDims, 1);
+            auto dimSzVec = vector<size_t>(numDims, 1);
             auto ptr = data->getPtr<T *>();
             dimSzVec[numDims - 1] = shape[numDims - 1];
 
@@ -98,13 +134,13 @@ namespace infini
 
                 builder << ptr[i];
                 for (size_t j = 0; j < numDims; ++j)
-                    if ((int)i % dimSzVec[j] == dimSzVec[j] - 1)
+                    if (i % dimSzVec[j] == dimSzVec[j] - 1)
                         builder << "]";
 
                 if (i != size() - 1)
                     builder << ", ";
 
-                auto column = (size_t)dimSzVec[numDims - 1];
+                auto column = dimSzVec[numDims - 1];
                 if (i % column == column - 1)
                     builder << std::endl;
             }
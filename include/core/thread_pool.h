@@ -0,0 +1,92 @@
+#pragma once
+#include "core/common.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace infini
+{
+
+    /**
+     * @brief A fixed set of worker threads running the loops of CPU kernels.
+     *
+     * A pool of `n` threads starts `n - 1` workers; the thread calling
+     * `parallel_for` is the n-th one. Idle workers spin for a while before
+     * sleeping, so consecutive kernels do not pay for waking them up. One
+     * pool can be shared by several runtimes and the application.
+     */
+    class ThreadPool
+    {
+    public:
+        using Task = std::function<void(size_t begin, size_t end)>;
+
+    private:
+        struct Job
+        {
+            const Task *task;
+            size_t end, chunk;
+        };
+
+        int threads;
+        std::chrono::microseconds spin;
+        vector<std::thread> workers;
+
+        std::mutex mutex;
+        std::condition_variable wake, done;
+        bool stopping = false;
+        // bumped for every job, polled by spinning workers
+        std::atomic<uint64_t> generation{0};
+        // the running job, null once all chunks are claimed
+        Job job{nullptr, 0, 0};
+        std::atomic<size_t> next{0};
+        int active = 0;
+        std::exception_ptr error;
+        // set while a caller runs a job; other callers run inline meanwhile
+        std::atomic<bool> busy{false};
+
+        // CPUs of thread i are cpus[i % cpus.size()]
+        vector<vector<int>> cpus;
+        unsigned affinityEpoch = 0;
+
+    public:
+        /**
+         * @param threads Number of threads including the caller. 0 means one
+         * per hardware thread.
+         * @param spin How long an idle worker polls for work before sleeping.
+         */
+        explicit ThreadPool(int threads = 0,
+                            std::chrono::microseconds spin =
+                                std::chrono::microseconds(100));
+        ~ThreadPool();
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        int getThreadCount() const { return threads; }
+
+        /**
+         * @brief Pins the workers, worker i - 1 to the CPUs `cpus[i %
+         * cpus.size()]`. Thread 0 is the caller, which pins itself. An empty
+         * list leaves the workers where they are.
+         */
+        void setAffinity(vector<vector<int>> cpus);
+
+        /**
+         * @brief Runs `task` over [begin, end) split into chunks of a multiple
+         * of `grain` iterations, starting at `begin`, on the caller and the
+         * workers, and waits for them. Loops of at most one chunk, nested
+         * calls and calls while another thread uses the pool run on the
+         * caller. The first exception thrown by a chunk is rethrown.
+         */
+        void parallel_for(size_t begin, size_t end, size_t grain,
+                          const Task &task);
+
+    private:
+        void loop(int index);
+        // claims and runs chunks of the current job
+        void work(const Job &job);
+    };
+
+} // namespace infini
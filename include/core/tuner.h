@@ -0,0 +1,75 @@
+#pragma once
+#include "core/kernel.h"
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace infini
+{
+
+    /**
+     * @brief Picks one of the registered kernel variants for each operator.
+     *
+     * Winners are cached per tuning key (device, op type, dtype, input
+     * shapes and attributes, see `encodeAttrs`), so operators with the same
+     * workload share one measurement.
+     * With an empty cache every operator runs its default variant. The
+     * choice for each operator is resolved once and kept by its guid until
+     * the cache changes or the operator is reshaped, so `run` does not build
+     * keys.
+     */
+    class KernelTuner
+    {
+    private:
+        // tuning key -> kernel name
+        std::map<string, string> cache;
+        int warmup = 1;
+        int repeat = 3;
+        // op guid -> its variant for the current shapes, filled by `select`
+        mutable std::shared_mutex resolvedMutex;
+        mutable std::unordered_map<UidBaseType,
+                                   const KernelRegistry::KernelRecord *>
+            resolved;
+
+        const KernelRegistry::KernelRecord &lookup(const Operator &op,
+                                                   Device device) const;
+
+    public:
+        static string getTuningKey(const Operator &op, Device device);
+
+        /**
+         * @brief Gets the cached winner of the operator, or the default variant
+         * if it has not been tuned.
+         */
+        const KernelRegistry::KernelRecord &select(const Operator &op,
+                                                   Device device) const;
+
+        /**
+         * @brief Times every candidate of every operator whose key is not cached
+         * yet and caches the fastest one. The graph must have been allocated
+         * by `dataMalloc`, since the candidates run on the actual tensors.
+         */
+        void tune(const Graph &graph, const RuntimeObj *runtime);
+
+        /**
+         * @brief Drops the variant resolved for `op`, e.g. after its shapes
+         * changed. Called by `GraphObj::shape_infer`.
+         */
+        void invalidate(const Operator &op);
+
+        void setRepeat(int warmup, int repeat);
+        void clear();
+        size_t size() const { return cache.size(); }
+        const std::map<string, string> &getCache() const { return cache; }
+
+        /**
+         * @brief Saves the cache as lines of "key<TAB>kernel name".
+         */
+        void save(const string &path) const;
+        /**
+         * @brief Merges the entries saved by `save` into the cache. Returns
+         * false if the file can not be opened.
+         */
+        bool load(const string &path);
+    };
+
+} // namespace infini
@@ -0,0 +1,63 @@
+#pragma once
+#include "core/runtime.h"
+#include "core/tensor.h"
+
+namespace infini
+{
+
+    class WeightArenaObj;
+    using WeightArena = Ref<WeightArenaObj>;
+
+    /**
+     * @brief An arena for weights and other constants, kept apart from the
+     * per-request activation arena planned by `GraphObj::dataMalloc`.
+     *
+     * The arena is one shared anonymous mapping, or a spill file of the
+     * runtime (see `NativeCpuRuntimeObj::setSpillDirectory`), holding each
+     * weight at a multiple of the runtime alignment. `seal` makes its pages
+     * read-only, so stray writes fault instead of corrupting the model.
+     * Graphs with the same weights, e.g. replicas of a model, can be bound
+     * to one arena with `bind`, and processes forked after it is built share
+     * its pages. The mapping lives as long as the arena or any blob bound to
+     * it.
+     */
+    class WeightArenaObj : public Object
+    {
+    private:
+        Runtime runtime;
+        Ref<void> mapping;
+        size_t bytes = 0;
+        // offset and bytes of each weight, in the order they were given
+        vector<pair<size_t, size_t>> entries;
+        bool sealed = false;
+
+    public:
+        /**
+         * @brief Lays out `weights` in a new arena, copies the data of the
+         * ones bound to data and binds all of them to the arena.
+         */
+        WeightArenaObj(Runtime runtime, const TensorVec &weights);
+
+        string toString() const override;
+        size_t getBytes() const { return bytes; }
+        size_t getCount() const { return entries.size(); }
+        bool isSealed() const { return sealed; }
+        /**
+         * @brief Checks whether `ptr` points into the arena.
+         */
+        bool contains(const void *ptr) const;
+
+        /**
+         * @brief Makes the arena read-only, after which writing to the
+         * weights faults. Sealing is permanent.
+         */
+        void seal();
+
+        /**
+         * @brief Binds `weights` to the arena, the i-th to the data of the
+         * i-th weight it was built from. Their sizes must match.
+         */
+        void bind(const TensorVec &weights) const;
+    };
+
+} // namespace infini
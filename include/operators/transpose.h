@@ -26,7 +26,7 @@ namespace infini
     std::string toString() const override;
     int numInputs() const override { return 1; }
     int numOutputs() const override { return 1; }
-    std::vector<int> getPermute() const { return transposePermute; }
+    const vector<int> &getPermute() const { return transposePermute; }
 
   private:
     vector<int> transposePermute;
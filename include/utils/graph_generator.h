@@ -0,0 +1,32 @@
+#pragma once
+#include "core/graph.h"
+
+namespace infini {
+
+/**
+ * @brief Builds a stack of `layers` transformer-like blocks on an input of
+ * shape [seqLen, hidden]. Each block has per-head attention
+ * (MatMul -> Transpose -> MatMul -> Relu -> MatMul, heads joined by Concat),
+ * an output projection, a two-layer Relu MLP of width 4 * hidden and two
+ * residual Adds, i.e. 7 * heads + 9 operators. `hidden` must be divisible by
+ * `heads`.
+ */
+Graph makeTransformerGraph(Runtime runtime, int layers, int seqLen, int hidden,
+                           int heads, DataType dtype = DataType::Float32);
+
+/**
+ * @brief Builds a chain of `depth` operators on tensors of `shape`, alternating
+ * Relu and an Add of the Relu output and the Relu input as a residual.
+ */
+Graph makeChainGraph(Runtime runtime, int depth, const Shape &shape,
+                     DataType dtype = DataType::Float32);
+
+/**
+ * @brief Builds a DAG whose input fans out to `width` independent branches of
+ * `depth` operators each (alternating Relu and Mul with a per-branch weight),
+ * joined by one Concat on the last dim.
+ */
+Graph makeFanOutGraph(Runtime runtime, int width, int depth, const Shape &shape,
+                      DataType dtype = DataType::Float32);
+
+} // namespace infini
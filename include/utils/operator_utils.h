@@ -5,6 +5,8 @@
 #include "core/operator.h"
 #include "core/tensor.h"
 
+#include <initializer_list>
+#include <limits>
 #include <numeric>
 
 namespace infini {
@@ -17,10 +19,66 @@ int get_real_axis(const int &axis, const int &rank);
 Shape locate_index(size_t inputN, const Shape &shape);
 // Delocate the ShapeIndex from Shape with broadcast
 size_t delocate_index(const Shape &shapeIndex, const Shape &shape,
-                      const Shape &stride);
+                      const Stride &stride);
+// Get the strides of a contiguous tensor of Shape
+Stride get_stride(const Shape &shape);
 // Convert KernelAttrs to a string representation
 std::string get_kernel_attrs_str(const KernelAttrs &kernelAttrs);
 
+// Alignment assumed by the vectorized fast paths of CPU kernels, enough for
+// aligned AVX loads and stores
+constexpr size_t kVectorAlignment = 32;
+// Call f with a zero of the narrowest index type that can address n elements:
+// int32_t if it fits, so index math of kernels stays 32-bit, else int64_t
+template <typename F> void dispatch_index(size_t n, F f) {
+    if (n <= size_t(std::numeric_limits<int32_t>::max()))
+        f(int32_t(0));
+    else
+        f(int64_t(0));
+}
+
+// Check whether all pointers are aligned to `alignment` bytes
+bool is_aligned(std::initializer_list<const void *> ptrs,
+                size_t alignment = kVectorAlignment);
+
+// Elements per task of CPU kernels running on the thread pool; smaller
+// tensors are computed on the calling thread. A multiple of kVectorAlignment,
+// so the chunks of aligned data stay aligned.
+constexpr size_t kParallelGrain = 1 << 14;
+
+// Compute out[i] = f(in[i]) over contiguous data, letting the compiler use
+// aligned vector accesses if all pointers are aligned to kVectorAlignment
+template <typename T, typename F>
+void apply_contiguous(const T *in, T *out, size_t n, F f) {
+    if (is_aligned({in, out})) {
+        auto a = static_cast<const T *>(
+            __builtin_assume_aligned(in, kVectorAlignment));
+        auto c = static_cast<T *>(__builtin_assume_aligned(out, kVectorAlignment));
+        for (size_t i = 0; i < n; ++i)
+            c[i] = f(a[i]);
+    } else {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = f(in[i]);
+    }
+}
+
+// Compute out[i] = f(in0[i], in1[i]) over contiguous data, like above
+template <typename T, typename F>
+void apply_contiguous(const T *in0, const T *in1, T *out, size_t n, F f) {
+    if (is_aligned({in0, in1, out})) {
+        auto a = static_cast<const T *>(
+            __builtin_assume_aligned(in0, kVectorAlignment));
+        auto b = static_cast<const T *>(
+            __builtin_assume_aligned(in1, kVectorAlignment));
+        auto c = static_cast<T *>(__builtin_assume_aligned(out, kVectorAlignment));
+        for (size_t i = 0; i < n; ++i)
+            c[i] = f(a[i], b[i]);
+    } else {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = f(in0[i], in1[i]);
+    }
+}
+
 } // namespace infini
 
 #endif
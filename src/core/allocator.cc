@@ -8,24 +8,19 @@ namespace infini
         used = 0;
         peak = 0;
         ptr = nullptr;
+        capacity = 0;
+        allocCount = 0;
 
-        // 'alignment' defaults to sizeof(uint64_t), because it is the length of
-        // the longest data type currently supported by the DataType field of
-        // the tensor
-        alignment = sizeof(uint64_t);
+        // Offsets are aligned like the arena itself, so every tensor starts
+        // at an address aligned to the runtime alignment, by default a whole
+        // cache line that no two tensors share.
+        alignment = runtime->getAlignment();
     }
 
-    Allocator::~Allocator()
-    {
-        if (this->ptr != nullptr)
-        {
-            runtime->dealloc(this->ptr);
-        }
-    }
+    Allocator::~Allocator() { release(); }
 
     size_t Allocator::alloc(size_t size)
     {
-        IT_ASSERT(this->ptr == nullptr);
         // pad the size to the multiple of alignment
         size = this->getAlignedSize(size);
 
@@ -77,7 +72,6 @@ namespace infini
 
     void Allocator::free(size_t addr, size_t size)
     {
-        IT_ASSERT(this->ptr == nullptr);
         size = getAlignedSize(size);
 
         // =================================== 作业 ===================================
@@ -131,14 +125,41 @@ namespace infini
 
     void *Allocator::getPtr()
     {
-        if (this->ptr == nullptr)
+        if (this->ptr == nullptr || this->peak > this->capacity)
         {
+            if (this->ptr != nullptr)
+                runtime->dealloc(this->ptr);
             this->ptr = runtime->alloc(this->peak);
-            printf("Allocator really alloc: %p %lu bytes\n", this->ptr, peak);
+            this->capacity = this->peak;
+            ++this->allocCount;
         }
         return this->ptr;
     }
 
+    void Allocator::setAlignment(size_t alignment)
+    {
+        IT_ASSERT(blocks.empty() && this->peak == 0);
+        IT_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+        this->alignment = alignment;
+    }
+
+    void Allocator::release()
+    {
+        if (this->ptr != nullptr)
+        {
+            runtime->dealloc(this->ptr);
+            this->ptr = nullptr;
+            this->capacity = 0;
+        }
+    }
+
+    void Allocator::reset()
+    {
+        blocks.clear();
+        used = 0;
+        peak = 0;
+    }
+
     size_t Allocator::getAlignedSize(size_t size)
     {
         return ((size - 1) / this->alignment + 1) * this->alignment;
@@ -0,0 +1,140 @@
+#include "core/batcher.h"
+#include "core/runtime.h"
+
+namespace infini
+{
+
+    Batcher::Batcher(Graph graph, int maxBatch,
+                     std::chrono::microseconds timeout)
+        : graph(std::move(graph)), maxBatch(maxBatch), timeout(timeout)
+    {
+        IT_ASSERT(maxBatch > 0);
+        for (auto &t : this->graph->getInputs())
+            if (!t->hasData() || t->isInput())
+            {
+                IT_ASSERT(!input, "Batcher supports graphs with one input");
+                input = t;
+            }
+        IT_ASSERT(input && input->getRank() > 0 && input->getDims()[0] > 0,
+                  "Batcher needs a batched graph input");
+        rowBytes = input->getBytes() / input->getDims()[0];
+        worker = std::thread([this] { loop(); });
+    }
+
+    Batcher::~Batcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+
+    std::future<Batcher::Result> Batcher::submit(vector<char> data)
+    {
+        IT_ASSERT(!data.empty() && data.size() % rowBytes == 0,
+                  "Request size is not a multiple of a batch entry");
+        Request request{std::move(data), 0, {}};
+        request.rows = request.input.size() / rowBytes;
+        auto future = request.result.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queuedRows += request.rows;
+            queue.emplace_back(std::move(request));
+        }
+        cv.notify_all();
+        return future;
+    }
+
+    size_t Batcher::getBatchCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return batches;
+    }
+
+    size_t Batcher::getRequestCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return requests;
+    }
+
+    void Batcher::loop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            cv.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty())
+                return;
+            // wait for a full batch, at most `timeout` after the first request
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+            cv.wait_until(lock, deadline, [this]
+                          { return stopping || queuedRows >= maxBatch; });
+
+            vector<Request> batch;
+            int rows = 0;
+            while (!queue.empty() &&
+                   (batch.empty() || rows + queue.front().rows <= maxBatch))
+            {
+                rows += queue.front().rows;
+                batch.emplace_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+            queuedRows -= rows;
+            lock.unlock();
+            runBatch(batch, rows);
+            lock.lock();
+        }
+    }
+
+    void Batcher::runBatch(vector<Request> &batch, int rows)
+    {
+        {
+            // counted before any caller can observe its result
+            std::lock_guard<std::mutex> lock(mutex);
+            ++batches;
+            requests += batch.size();
+        }
+        try
+        {
+            auto dims = input->getDims();
+            dims[0] = rows;
+            graph->reshape({{input, dims}});
+            // concatenate the requests along dim 0
+            auto dst = input->getRawDataPtr<char *>();
+            for (auto &request : batch)
+            {
+                std::memcpy(dst, request.input.data(), request.input.size());
+                dst += request.input.size();
+            }
+            graph->getRuntime()->run(graph);
+
+            auto outputs = graph->getOutputs();
+            vector<Result> results(batch.size(), Result(outputs.size()));
+            for (size_t i = 0; i < outputs.size(); ++i)
+            {
+                auto &output = outputs[i];
+                IT_ASSERT(output->getRank() > 0 &&
+                              output->getDims()[0] == rows,
+                          "Graph outputs must be batched along dim 0");
+                size_t outRowBytes = output->getBytes() / rows;
+                auto src = output->getRawDataPtr<char *>();
+                for (size_t r = 0; r < batch.size(); ++r)
+                {
+                    size_t bytes = batch[r].rows * outRowBytes;
+                    results[r][i].assign(src, src + bytes);
+                    src += bytes;
+                }
+            }
+            for (size_t r = 0; r < batch.size(); ++r)
+                batch[r].result.set_value(std::move(results[r]));
+        }
+        catch (...)
+        {
+            for (auto &request : batch)
+                request.result.set_exception(std::current_exception());
+        }
+    }
+
+} // namespace infini
@@ -0,0 +1,59 @@
+#include "core/execution_context.h"
+
+namespace infini
+{
+
+    thread_local const ExecutionContext *currentExecutionContext = nullptr;
+
+    void *getExecutionContextPtr(const ExecutionContext *context,
+                                 UidBaseType fuid)
+    {
+        return context->getPtr(fuid);
+    }
+
+    ExecutionContext::ExecutionContext(Graph graph) : graph(std::move(graph))
+    {
+        auto &plan = this->graph->getMemoryPlan();
+        IT_ASSERT(plan.getSteps() == (int)this->graph->getOperators().size(),
+                  "The graph must be allocated by dataMalloc first");
+        auto runtime = this->graph->getRuntime();
+        if (plan.getPeak() > 0)
+            arena = Ref<void>(runtime->alloc(plan.getPeak()),
+                              [runtime](void *ptr) { runtime->dealloc(ptr); });
+        auto base = static_cast<char *>(arena.get());
+        for (auto &p : plan.getPlacements())
+        {
+            if (p.isWorkspace())
+                workspaces[p.guid] = base + p.offset;
+            else
+                ptrs[p.fuid] = base + p.offset;
+        }
+    }
+
+    void ExecutionContext::bindExternalData(const Tensor &tensor, void *ptr)
+    {
+        IT_ASSERT(graph->isExternallyBound(tensor),
+                  "Tensor must be bound by the graph first");
+        IT_ASSERT(ptr != nullptr &&
+                      reinterpret_cast<uintptr_t>(ptr) %
+                              tensor->getDType().getSize() ==
+                          0,
+                  "External buffer is not aligned to its data type");
+        ptrs[tensor->getFuid()] = ptr;
+    }
+
+    ExecutionContext::Scope::Scope(const ExecutionContext &context)
+        : prev(currentExecutionContext)
+    {
+        currentExecutionContext = &context;
+    }
+
+    ExecutionContext::Scope::~Scope() { currentExecutionContext = prev; }
+
+    void ExecutionContext::run()
+    {
+        Scope scope(*this);
+        graph->getRuntime()->run(graph);
+    }
+
+} // namespace infini
@@ -1,7 +1,12 @@
 #include "core/graph.h"
+#include "core/execution_context.h"
+#include "core/kernel.h"
+#include "core/tuner.h"
 #include <algorithm>
 #include <numeric>
 #include <queue>
+#include <sys/mman.h>
+#include <unistd.h>
 #include "operators/matmul.h"
 #include "operators/transpose.h"
 namespace infini
@@ -10,6 +15,9 @@ namespace infini
     void GraphObj::addOperatorAndConnect(const Operator &op)
     {
         sorted = false;
+        topology = nullptr;
+        planCache.clear();
+        opIndex[op->getGuid()] = ops.size();
         ops.push_back(op);
         for (auto &input : op->getInputs())
         {
@@ -37,8 +45,66 @@ namespace infini
         }
     }
 
+    void GraphObj::removeOperator(Operator op)
+    {
+        auto it = opIndex.find(op->getGuid());
+        if (it == opIndex.end() || ops[it->second] != op)
+            return;
+        ops[it->second] = nullptr;
+        opIndex.erase(it);
+        topology = nullptr;
+        planCache.clear();
+        ++removedOps;
+    }
+
+    void GraphObj::removeTensor(Tensor tensor)
+    {
+        auto it = tensorIndex.find(tensor->getFuid());
+        if (it == tensorIndex.end() || tensors[it->second] != tensor)
+            return;
+        tensors[it->second] = nullptr;
+        tensorIndex.erase(it);
+        boundTensors.erase(tensor->getFuid());
+        topology = nullptr;
+        planCache.clear();
+        ++removedTensors;
+    }
+
+    void GraphObj::compact() const
+    {
+        if (removedTensors > 0)
+        {
+            tensors.erase(std::remove(tensors.begin(), tensors.end(), nullptr),
+                          tensors.end());
+            for (size_t i = 0; i < tensors.size(); ++i)
+                tensorIndex[tensors[i]->getFuid()] = i;
+            removedTensors = 0;
+        }
+        if (removedOps > 0)
+        {
+            ops.erase(std::remove(ops.begin(), ops.end(), nullptr), ops.end());
+            reindexOperators();
+            removedOps = 0;
+        }
+    }
+
+    void GraphObj::reindexOperators() const
+    {
+        for (size_t i = 0; i < ops.size(); ++i)
+            opIndex[ops[i]->getGuid()] = i;
+    }
+
+    const GraphTopology &GraphObj::getTopology() const
+    {
+        compact();
+        if (!topology)
+            topology = make_ref<GraphTopology>(ops, tensors);
+        return *topology;
+    }
+
     string GraphObj::toString() const
     {
+        compact();
         std::ostringstream oss;
         oss << "Graph Tensors:\n";
         for (const auto &tensor : tensors)
@@ -62,41 +128,181 @@ namespace infini
 
     bool GraphObj::topo_sort()
     {
+        compact();
         if (this->sorted)
         {
             return true;
         }
-        std::vector<Operator> sorted;
-        std::unordered_set<OperatorObj *> flags;
-        sorted.reserve(ops.size());
-        flags.reserve(ops.size());
-        while (sorted.size() < ops.size())
+        auto order = getTopology().topoOrder();
+        if (order.size() < ops.size())
         {
-            // Any node is move to sorted in this loop.
-            auto modified = false;
-            for (auto const &op : ops)
+            return false;
+        }
+        reorderOperators(order);
+        return this->sorted = true;
+    }
+
+    bool GraphObj::schedule(ScheduleGoal goal)
+    {
+        // 图的外部数据不在 arena 中，不影响峰值
+        auto &topo = getTopology();
+        auto external = getExternalTensors();
+        vector<size_t> bytes(topo.getTensorCount());
+        for (int t = 0; t < topo.getTensorCount(); ++t)
+            if (!external.count(topo.getTensor(t)))
+                bytes[t] = topo.getTensor(t)->getBytes();
+        auto order = scheduleOps(topo, goal, bytes);
+        if (order.size() < ops.size())
+            return false;
+        reorderOperators(order);
+        return this->sorted = true;
+    }
+
+    RematerializationReport GraphObj::rematerialize(size_t budget)
+    {
+        RematerializationReport report;
+        report.budget = budget;
+        auto plan = planMemory(false);
+        report.peakBefore = plan.getPeak();
+        // 每一步在峰值处选择单位重算代价节省字节最多的 tensor
+        for (size_t rounds = ops.size(); plan.getPeak() > budget && rounds > 0;
+             --rounds)
+        {
+            int peakStep = plan.getPeakStep();
+            std::unordered_map<UidBaseType, int> lastUse;
+            for (auto &p : plan.getPlacements())
+                if (!p.isWorkspace())
+                    lastUse[p.fuid] = p.lastUse;
+            Tensor best;
+            size_t bestCost = 0;
+            double bestScore = 0;
+            for (auto &p : plan.getPlacements())
             {
-                if (auto const &inputs = op->getInputs();
-                    flags.find(op.get()) == flags.end() &&
-                    std::all_of(inputs.begin(), inputs.end(),
-                                [&flags](auto const &input)
-                                {
-                                    auto ptr = input->getSource().get();
-                                    return !ptr || flags.find(ptr) != flags.end();
-                                }))
+                // 只有跨越峰值且峰值时不被读取的 tensor 才能释放
+                if (p.isWorkspace() || p.firstUse >= peakStep ||
+                    p.lastUse <= peakStep)
+                    continue;
+                auto tensor = getTensor(p.fuid);
+                auto source = tensor->getSource();
+                size_t cost = source ? getRecomputeCost(source) : 0;
+                if (cost == 0)
+                    continue;
+                // 图的输出等在峰值后没有使用者的 tensor 无法通过重算释放
+                bool readAtPeak = false, readLater = false;
+                for (auto &target : tensor->getTargets())
                 {
-                    modified = true;
-                    sorted.emplace_back(op);
-                    flags.insert(op.get());
+                    int pos = opIndex.at(target->getGuid());
+                    readAtPeak |= pos == peakStep;
+                    readLater |= pos > peakStep;
+                }
+                if (readAtPeak || !readLater)
+                    continue;
+                // 重算的输入若本应在峰值前释放，则需一直保留到重算处
+                size_t penalty = 0;
+                std::unordered_set<UidBaseType> seen;
+                for (auto &input : source->getInputs())
+                    if (auto it = lastUse.find(input->getFuid());
+                        seen.insert(input->getFuid()).second &&
+                        it != lastUse.end() && it->second < peakStep)
+                        penalty += input->getBytes();
+                if (penalty >= p.bytes)
+                    continue;
+                double score = double(p.bytes - penalty) / cost;
+                if (score > bestScore)
+                {
+                    best = tensor;
+                    bestCost = cost;
+                    bestScore = score;
                 }
             }
-            if (!modified)
+            if (!best)
+                break;
+            auto copy = recompute(best, peakStep);
+            ++report.recomputed;
+            report.extraCost += bestCost;
+            report.decisions.emplace_back(
+                "recompute tensor " + std::to_string(best->getFuid()) + " (" +
+                std::to_string(best->getBytes()) + " bytes) by " +
+                copy->getOpType().toString() + "[" +
+                std::to_string(copy->getGuid()) + "], cost " +
+                std::to_string(bestCost));
+            plan = planMemory(false);
+        }
+        report.peakAfter = plan.getPeak();
+        return report;
+    }
+
+    Operator GraphObj::recompute(const Tensor &tensor, int step)
+    {
+        auto source = tensor->getSource();
+        OpVec late;
+        size_t first = ops.size();
+        for (auto &target : tensor->getTargets())
+            if (size_t pos = opIndex.at(target->getGuid()); (int)pos > step &&
+                std::find(late.begin(), late.end(), target) == late.end())
             {
-                return false;
+                late.emplace_back(target);
+                first = std::min(first, pos);
+            }
+        IT_ASSERT(!late.empty(), "Tensor is not used after step " +
+                                     std::to_string(step));
+        auto copy = addTensor(tensor->getDims(), tensor->getDType());
+        auto op = source->clone(source->getInputs(), {copy});
+        addOperatorAndConnect(op);
+        for (auto &target : late)
+        {
+            auto &inputs = target->getInputs();
+            auto uses = std::count(inputs.begin(), inputs.end(), tensor);
+            target->replaceInput(tensor, copy);
+            tensor->removeTarget(target);
+            target->removePredecessors(source);
+            source->removeSuccessors(target);
+            for (int i = 0; i < uses; ++i)
+            {
+                copy->addTarget(target);
+                target->addPredecessors(op);
+                op->addSuccessors(target);
             }
         }
-        this->ops = std::move(sorted);
-        return this->sorted = true;
+        // 原算子的输出不再被使用时删除原算子
+        if (tensor->getTargets().empty())
+        {
+            for (auto &input : source->getInputs())
+                input->removeTarget(source);
+            for (auto &pred : source->getPredecessors())
+                pred->removeSuccessors(source);
+            removeOperator(source);
+            removeTensor(tensor);
+        }
+        // 重算紧挨在第一个使用者之前执行
+        auto firstOp = ops[first];
+        compact();
+        vector<int> order;
+        order.reserve(ops.size());
+        for (int i = 0; i + 1 < (int)ops.size(); ++i)
+        {
+            if (ops[i] == firstOp)
+                order.emplace_back(ops.size() - 1);
+            order.emplace_back(i);
+        }
+        reorderOperators(order);
+        sorted = true;
+        return op;
+    }
+
+    void GraphObj::reorderOperators(const vector<int> &order)
+    {
+        OpVec reordered;
+        reordered.reserve(ops.size());
+        for (int op : order)
+            reordered.emplace_back(ops[op]);
+        if (reordered != ops)
+        {
+            this->ops = std::move(reordered);
+            reindexOperators();
+            topology = nullptr;
+            planCache.clear();
+        }
     }
 
     void GraphObj::optimize()
@@ -108,10 +314,14 @@ namespace infini
         // 2. 合并算子（例如，矩阵乘算子中含有属性transA、transB，如果其输入存在transpose，且对最后两个维度做交换，就可以将transpose融入到矩阵乘算子的属性中去）
         // =================================== 作业 ===================================
         // 1. 去除冗余的transpose算子
+        // 删除的算子在 ops 中留下空位，下标不会移动；新加入的算子不再访问
+        compact();
         auto ops_size = ops.size();
         for (size_t i = 0; i < ops_size; i++)
         {
             auto op = ops[i];
+            if (!op)
+                continue;
             if (op->getOpType() == OpType::Transpose){
                 auto op_transpose = std::dynamic_pointer_cast<TransposeObj>(op);
                 auto input = op_transpose->getInputs(0);
@@ -151,8 +361,6 @@ namespace infini
                     for (auto suc : op->getSuccessors()){
                         suc->removePredecessors(op);
                     }
-                    ops_size -= 2;
-                    i -= 2;
                     this->removeOperator(op);
                     this->removeOperator(preOp);
                     this->removeTensor(input);
@@ -197,8 +405,6 @@ namespace infini
                 op_mul->inputs[0] = transpose_input;
                 this->removeTensor(mata);
                 this->removeOperator(pre_op_mul_a);
-                ops_size--;
-                i--;
                 //删除中间tensor
             }
             if (pre_op_mul_b && pre_op_mul_b->getOpType() == OpType::Transpose && matb->targets.size() == 1){
@@ -227,93 +433,369 @@ namespace infini
                 op_mul->inputs[1] = transpose_input;
                 this->removeTensor(matb);
                 this->removeOperator(pre_op_mul_b);
-                ops_size--;
-                i--;
             }
         }
         }
+        // 输入被替换过，连接关系已改变
+        topology = nullptr;
+        planCache.clear();
     }
 
     Tensor GraphObj::getTensor(int fuid) const
     {
-        for (auto tensor : tensors)
+        auto it = tensorIndex.find(fuid);
+        return it == tensorIndex.end() ? nullptr : tensors[it->second];
+    }
+
+    Operator GraphObj::getOperator(UidBaseType guid) const
+    {
+        auto it = opIndex.find(guid);
+        return it == opIndex.end() ? nullptr : ops[it->second];
+    }
+
+    void GraphObj::shape_infer()
+    {
+        compact();
+        for (auto &op : ops)
+            inferOutputShapes(op);
+    }
+
+    void GraphObj::shape_infer(const TensorVec &changed)
+    {
+        IT_ASSERT(topo_sort() == true);
+        auto &topo = getTopology();
+        vector<char> dirty(tensors.size(), 0);
+        for (auto &tensor : changed)
+            if (int id = topo.getTensorId(tensor.get()); id >= 0)
+                dirty[id] = 1;
+        // 按拓扑顺序只重新推导输入发生变化的算子
+        for (int step = 0; step < topo.getOpCount(); ++step)
         {
-            if (tensor->getFuid() == fuid)
+            auto inputs = topo.getInputs(step);
+            if (std::none_of(inputs.begin(), inputs.end(),
+                             [&](int t) { return dirty[t]; }))
+                continue;
+            for (auto &output : inferOutputShapes(ops[step]))
+                dirty[topo.getTensorId(output.get())] = 1;
+        }
+    }
+
+    TensorVec GraphObj::inferOutputShapes(const Operator &op)
+    {
+        // 形状变化后重新选择调优的 kernel
+        if (runtime->hasTuner())
+            runtime->getTuner().invalidate(op);
+        auto ans = op->inferShape();
+        IT_ASSERT(ans.has_value());
+        auto &outputs = op->getOutputs();
+        IT_ASSERT(ans.value().size() == outputs.size());
+        // replace the old outputshape and size with new one
+        TensorVec changed;
+        for (size_t i = 0; i < outputs.size(); ++i)
+            if (ans.value()[i] != outputs[i]->getDims())
             {
-                return tensor;
+                outputs[i]->setShape(ans.value()[i]);
+                changed.emplace_back(outputs[i]);
             }
-        }
-        return nullptr;
+        return changed;
     }
 
-    void GraphObj::shape_infer()
+    void GraphObj::reshape(const vector<pair<Tensor, Shape>> &inputShapes)
     {
-        for (auto &op : ops)
+        TensorVec changed;
+        for (auto &[tensor, shape] : inputShapes)
         {
-            auto ans = op->inferShape();
-            IT_ASSERT(ans.has_value());
-            auto oldOutputs = op->getOutputs();
-            IT_ASSERT(ans.value().size() == oldOutputs.size());
-            // replace the old outputshape and size with new one
-            for (int i = 0; i < (int)ans.value().size(); ++i)
+            IT_ASSERT(!tensor->getSource(), "Only graph inputs can be reshaped");
+            if (tensor->getDims() != shape)
             {
-                auto newShape = ans.value()[i];
-                auto oldShape = oldOutputs[i]->getDims();
-                auto fuid = oldOutputs[i]->getFuid();
-                if (newShape != oldShape)
-                {
-                    auto tensor = this->getTensor(fuid);
-                    tensor->setShape(newShape);
-                }
+                tensor->setShape(shape);
+                changed.emplace_back(tensor);
             }
         }
+        if (changed.empty() && !memoryPlan.getPlacements().empty())
+            return;
+        shape_infer(changed);
+
+        // 同一个桶内的形状复用缓存的内存计划
+        vector<size_t> bucket;
+        auto external = getExternalTensors();
+        for (auto &tensor : tensors)
+            if (!external.count(tensor.get()))
+                bucket.emplace_back(getBucketBytes(tensor->getBytes()));
+        for (auto &op : ops)
+            bucket.emplace_back(getBucketBytes(getWorkspaceSize(op)));
+        auto it = planCache.find(bucket);
+        if (it == planCache.end())
+            it = planCache.emplace(bucket, planMemory(true)).first;
+        dataMalloc(it->second);
     }
 
-    void GraphObj::dataMalloc()
+    size_t GraphObj::getBucketBytes(size_t bytes)
+    {
+        if (bytes <= 64)
+            return 64;
+        // 8 steps per power of two, i.e. at most 1/8 is wasted
+        size_t step = (size_t(1) << (63 - __builtin_clzll(bytes))) / 8;
+        return (bytes + step - 1) / step * step;
+    }
+
+    std::unordered_set<TensorObj *> GraphObj::getExternalTensors() const
+    {
+        // 已绑定外部数据（如 mmap 的权重）的输入tensor不在 arena 中，
+        // 调用者通过 bindExternalData 绑定的输入和输出也不在
+        compact();
+        std::unordered_set<UidBaseType> placed;
+        for (auto &p : memoryPlan.getPlacements())
+            placed.insert(p.fuid);
+        std::unordered_set<TensorObj *> ret;
+        for (auto &tensor : tensors)
+            if (boundTensors.count(tensor->getFuid()) ||
+                (!tensor->getSource() && tensor->hasData() &&
+                 !placed.count(tensor->getFuid())))
+                ret.insert(tensor.get());
+        return ret;
+    }
+
+    void GraphObj::dataMalloc() { dataMalloc(planMemory(false)); }
+
+    MemoryPlan GraphObj::planMemory(bool bucketed)
     {
         // topological sorting first
         IT_ASSERT(topo_sort() == true);
 
-        // =================================== 作业 ===================================
-        // TODO：利用 allocator 给计算图分配内存
-        // HINT: 获取分配好的内存指针后，可以调用 tensor 的 setDataBlob 函数给 tensor 绑定内存
-        // =================================== 作业 ===================================
-        // 为每个tensor分配内存
-        std::unordered_map<int, size_t> tensorOffsets;  // 记录每个tensor的内存偏移量
-        
-        // 1. 为所有输入tensor分配内存
-        for (auto &tensor : tensors) {
-            if (!tensor->getSource()) {  // 输入tensor没有source
-                size_t bytes = tensor->getBytes();
+        // 按拓扑顺序计算每个tensor的生命周期 [firstUse, lastUse]，
+        // 中间tensor在最后一个使用它的算子执行后释放，以便复用内存。
+        // 图的输入和输出在整个执行过程中都是活跃的。
+        auto &topo = getTopology();
+        int steps = ops.size(), lastStep = std::max(steps, 1) - 1;
+        auto lastUse = topo.lastUses();
+
+        auto external = getExternalTensors();
+        allocator.reset();
+        MemoryPlan plan(steps);
+        vector<pair<size_t, size_t>> blocks(tensors.size());
+        auto place = [&](int id, int step, string producer)
+        {
+            auto tensor = topo.getTensor(id);
+            size_t bytes = bucketed ? getBucketBytes(tensor->getBytes())
+                                    : tensor->getBytes();
+            size_t offset = allocator.alloc(bytes);
+            blocks[id] = {offset, bytes};
+            int last = (topo.getSource(id) < 0 || topo.getTargets(id).empty())
+                           ? lastStep
+                           : lastUse[id];
+            plan.add({tensor->getFuid(), tensor->getGuid(), offset, bytes, step,
+                      last, std::move(producer)});
+            return last;
+        };
+
+        // 1. 为所有输入tensor分配内存，已绑定外部数据的除外；
+        //    权重放在单独的权重 arena 中
+        for (int id = 0; id < topo.getTensorCount(); ++id)
+            if (auto tensor = topo.getTensor(id);
+                topo.getSource(id) < 0 && !external.count(tensor) &&
+                !tensor->isWeight())
+                place(id, 0, "input");
+        // 2. 按拓扑顺序为算子的输出tensor分配内存，并释放不再使用的tensor；
+        //    已绑定外部数据的图输出除外
+        vector<vector<int>> frees(steps);
+        for (int step = 0; step < steps; ++step)
+        {
+            auto &op = ops[step];
+            auto producer =
+                string(op->getOpType().toString()) + "[" +
+                std::to_string(op->getGuid()) + "]";
+            for (int output : topo.getOutputs(step))
+                if (external.count(topo.getTensor(output)))
+                    continue;
+                else if (int last = place(output, step, producer);
+                         last < lastStep)
+                    frees[last].emplace_back(output);
+            // 算子的 workspace 只在该步存活，与输入输出同时分配
+            if (size_t bytes = getWorkspaceSize(op); bytes > 0)
+            {
+                if (bucketed)
+                    bytes = getBucketBytes(bytes);
                 size_t offset = allocator.alloc(bytes);
-                tensorOffsets[tensor->getFuid()] = offset;
+                plan.add({kWorkspaceFuid, op->getGuid(), offset, bytes, step,
+                          step, producer + ".workspace"});
+                allocator.free(offset, bytes);
             }
+            for (int id : frees[step])
+                allocator.free(blocks[id].first, blocks[id].second);
         }
-        // 2. 按拓扑顺序为算子的输出tensor分配内存
-        for (auto &op : ops) {
-            for (auto &output : op->getOutputs()) {
-                size_t bytes = output->getBytes();
-                size_t offset = allocator.alloc(bytes);
-                tensorOffsets[output->getFuid()] = offset;
+        plan.setPeak(allocator.getPeak());
+        return plan;
+    }
+
+    void GraphObj::dataMalloc(const MemoryPlan &plan)
+    {
+        IT_ASSERT(topo_sort() == true);
+        IT_ASSERT(plan.getSteps() == (int)ops.size(),
+                  "Memory plan does not match the graph");
+        memoryPlan = plan;
+        // 整个 arena 作为一个块分配，只在不够大时重新分配
+        allocator.reset();
+        if (plan.getPeak() > 0)
+            allocator.alloc(plan.getPeak());
+        auto basePtr = static_cast<char *>(allocator.getPtr());
+        workspaces.clear();
+        for (auto &p : plan.getPlacements())
+        {
+            if (p.isWorkspace())
+            {
+                auto op = getOperator(p.guid);
+                IT_ASSERT(op && getWorkspaceSize(op) <= p.bytes &&
+                              p.offset + p.bytes <= plan.getPeak(),
+                          "Memory plan does not match the graph");
+                workspaces[p.guid] = basePtr + p.offset;
+                continue;
             }
+            auto tensor = getTensor(p.fuid);
+            IT_ASSERT(tensor && tensor->getBytes() <= p.bytes &&
+                          p.offset + p.bytes <= plan.getPeak(),
+                      "Memory plan does not match the graph");
+            // 外部绑定的缓冲区优先于计划中的位置
+            if (boundTensors.count(p.fuid))
+                continue;
+            tensor->setDataBlob(
+                make_ref<BlobObj>(runtime, basePtr + p.offset));
         }
-        // 3. 获取实际分配的内存指针并绑定到tensor
-        void* basePtr = allocator.getPtr();
-        for (auto &tensor : tensors) {
-            auto fuid = tensor->getFuid();
-            if (tensorOffsets.find(fuid) != tensorOffsets.end()) {
-                size_t offset = tensorOffsets[fuid];
-                char* tensorPtr = static_cast<char*>(basePtr) + offset;
-                auto blob = make_ref<BlobObj>(runtime, tensorPtr);
-                tensor->setDataBlob(blob);
-            }
+        arenaBase = basePtr;
+        pageHints.clear();
+        if (auto cpu = as<NativeCpuRuntimeObj>(runtime);
+            cpu && basePtr && cpu->isSpilled(basePtr))
+            planPageHints(plan);
+        for (auto &op : ops)
+            IT_ASSERT(getWorkspaceSize(op) == 0 ||
+                          workspaces.count(op->getGuid()),
+                      "Memory plan does not match the graph");
+
+        // 未绑定数据的权重放入权重 arena，已在其中的权重一并迁移
+        auto weights = getArenaWeights();
+        if (std::any_of(weights.begin(), weights.end(),
+                        [](auto &t) { return !t->hasData(); }))
+            weightArena = make_ref<WeightArenaObj>(runtime, weights);
+    }
+
+    void GraphObj::planPageHints(const MemoryPlan &plan)
+    {
+        size_t page = sysconf(_SC_PAGESIZE);
+        int steps = plan.getSteps();
+        pageHints.assign(steps, {});
+        std::unordered_map<UidBaseType, const TensorPlacement *> placed;
+        for (auto &p : plan.getPlacements())
+        {
+            if (!p.isWorkspace())
+                placed[p.fuid] = &p;
+            // only whole pages inside the block, so live neighbours keep
+            // theirs; graph inputs and outputs live to the last step
+            size_t begin = (p.offset + page - 1) / page * page,
+                   end = (p.offset + p.bytes) / page * page;
+            if (p.lastUse < steps - 1 && begin < end)
+                pageHints[p.lastUse].dontNeed.emplace_back(begin, end - begin);
+        }
+        // the inputs of each operator are read ahead before the previous one
+        for (int step = 0; step < steps; ++step)
+            for (auto &input : ops[step]->getInputs())
+                if (auto it = placed.find(input->getFuid()); it != placed.end())
+                {
+                    auto &p = *it->second;
+                    size_t begin = p.offset / page * page,
+                           end = (p.offset + p.bytes + page - 1) / page * page;
+                    pageHints[std::max(step - 1, 0)].willNeed.emplace_back(
+                        begin, end - begin);
+                }
+    }
+
+    namespace
+    {
+        void adviseRanges(char *base, const vector<pair<size_t, size_t>> &ranges,
+                          int advice)
+        {
+            // hints only, failures are ignored
+            for (auto &[offset, bytes] : ranges)
+                madvise(base + offset, bytes, advice);
+        }
+    } // namespace
+
+    void GraphObj::adviseBefore(size_t step) const
+    {
+        if (step >= pageHints.size())
+            return;
+        auto base = currentExecutionContext
+                        ? static_cast<char *>(currentExecutionContext->getArena())
+                        : arenaBase;
+        adviseRanges(base, pageHints[step].willNeed, MADV_WILLNEED);
+    }
+
+    void GraphObj::adviseAfter(size_t step) const
+    {
+        if (step >= pageHints.size())
+            return;
+        auto base = currentExecutionContext
+                        ? static_cast<char *>(currentExecutionContext->getArena())
+                        : arenaBase;
+        adviseRanges(base, pageHints[step].dontNeed, MADV_DONTNEED);
+    }
+
+    size_t GraphObj::getWorkspaceSize(const Operator &op) const
+    {
+        return KernelRegistry::getInstance().getWorkspaceSize(
+            KernelAttrs{runtime->getDevice(), op->getOpType().underlying()},
+            op);
+    }
+
+    void *GraphObj::getWorkspace(const Operator &op) const
+    {
+        if (currentExecutionContext)
+            return currentExecutionContext->getWorkspace(op->getGuid());
+        auto it = workspaces.find(op->getGuid());
+        return it == workspaces.end() ? nullptr : it->second;
+    }
+
+    TensorVec GraphObj::getArenaWeights() const
+    {
+        compact();
+        TensorVec ret;
+        for (auto &tensor : tensors)
+        {
+            if (!tensor->isWeight())
+                continue;
+            if (!tensor->hasData() ||
+                (weightArena && weightArena->contains(
+                                    tensor->getDataBlob()->getPtr<void *>())))
+                ret.emplace_back(tensor);
         }
-        allocator.info();
+        return ret;
+    }
+
+    void GraphObj::setWeightArena(const WeightArena &arena)
+    {
+        arena->bind(getArenaWeights());
+        weightArena = arena;
+    }
+
+    void GraphObj::bindExternalData(const Tensor &tensor, void *ptr)
+    {
+        IT_ASSERT(tensor && getTensor(tensor->getFuid()) == tensor,
+                  "Tensor is not in the graph");
+        IT_ASSERT(!tensor->getSource() || tensor->getTargets().empty(),
+                  "Only graph inputs and outputs can be bound");
+        IT_ASSERT(ptr != nullptr &&
+                      reinterpret_cast<uintptr_t>(ptr) %
+                              tensor->getDType().getSize() ==
+                          0,
+                  "External buffer is not aligned to its data type");
+        // 绑定的张量不再放入 arena，缓存的计划随之失效
+        if (boundTensors.insert(tensor->getFuid()).second)
+            planCache.clear();
+        tensor->setDataBlob(make_ref<BlobObj>(runtime, ptr));
     }
 
     Tensor GraphObj::addTensor(Shape dim, DataType dtype)
     {
-        return tensors.emplace_back(make_ref<TensorObj>(dim, dtype, runtime));
+        return addTensor(make_ref<TensorObj>(dim, dtype, runtime));
     }
 
     Tensor GraphObj::addTensor(const Tensor &tensor)
@@ -322,7 +804,10 @@ namespace infini
                   std::string("Tensor runtime mismatch: cannot add a tenosr in ") +
                       tensor->getRuntime()->toString() + " to " +
                       runtime->toString());
+        tensorIndex[tensor->getFuid()] = tensors.size();
         tensors.emplace_back(tensor);
+        topology = nullptr;
+        planCache.clear();
         return tensor;
     }
 
@@ -339,45 +824,47 @@ namespace infini
     // "predecessors" and "successors" of an operator of "ops" must be in "ops".
     bool GraphObj::checkValid() const
     {
+        compact();
+        auto hasOp = [this](const Operator &op)
+        { return op && getOperator(op->getGuid()) == op; };
+        auto hasTensor = [this](const Tensor &tensor)
+        { return tensor && getTensor(tensor->getFuid()) == tensor; };
         for (auto tensor : tensors)
         {
             IT_ASSERT(!(tensor->getTargets().size() == 0 &&
                         nullptr == tensor->getSource()));
             for (auto op : tensor->getTargets())
             {
-                IT_ASSERT(std::find(ops.begin(), ops.end(), op) != ops.end());
+                IT_ASSERT(hasOp(op));
             }
             auto op = tensor->getSource();
-            IT_ASSERT(!(op && std::find(ops.begin(), ops.end(), op) == ops.end()));
+            IT_ASSERT(!(op && !hasOp(op)));
         }
         for (auto op : ops)
         {
             for (auto tensor : op->getInputs())
             {
-                IT_ASSERT(std::find(tensors.begin(), tensors.end(), tensor) !=
-                          tensors.end());
+                IT_ASSERT(hasTensor(tensor));
             }
             for (auto tensor : op->getOutputs())
             {
-                IT_ASSERT(std::find(tensors.begin(), tensors.end(), tensor) !=
-                          tensors.end());
+                IT_ASSERT(hasTensor(tensor));
             }
             for (auto pre : op->getPredecessors())
             {
-                IT_ASSERT(std::find(ops.begin(), ops.end(), pre) != ops.end());
+                IT_ASSERT(hasOp(pre));
             }
             for (auto suc : op->getSuccessors())
             {
-                IT_ASSERT(std::find(ops.begin(), ops.end(), suc) != ops.end());
+                IT_ASSERT(hasOp(suc));
             }
         }
-        std::set<UidBaseType> s;
         // check whether two tensors with the same FUID exist
+        std::unordered_set<UidBaseType> s;
         for (auto tensor : tensors)
         {
-            int cnt = s.count(tensor->getFuid());
-            IT_ASSERT(cnt == 0, std::to_string(tensor->getFuid()));
-            s.insert(tensor->getFuid());
+            IT_ASSERT(s.insert(tensor->getFuid()).second,
+                      std::to_string(tensor->getFuid()));
         }
         return true;
     }
@@ -0,0 +1,236 @@
+#include "core/graph_cache.h"
+#include "core/serializer.h"
+#include "core/tuner.h"
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace infini
+{
+
+    namespace
+    {
+        constexpr uint64_t kCacheVersion = 3;
+
+        // Writes to a temporary file of this writer first, so readers never
+        // see half of it and concurrent writers of one entry do not mix.
+        template <typename F>
+        void writeFile(const string &path, F write)
+        {
+            static std::atomic<unsigned> counter{0};
+            string tmp = path + ".tmp." + std::to_string(getpid()) + "." +
+                         std::to_string(counter++);
+            try
+            {
+                write(tmp);
+                IT_ASSERT(std::rename(tmp.c_str(), path.c_str()) == 0,
+                          "Can not write " + path);
+            }
+            catch (...)
+            {
+                std::remove(tmp.c_str());
+                throw;
+            }
+        }
+    } // namespace
+
+    GraphCache::GraphCache(string dir) : dir(std::move(dir))
+    {
+        std::filesystem::create_directories(this->dir);
+    }
+
+    uint64_t GraphCache::getKey(const Graph &graph)
+    {
+        uint64_t key = hashGraph(graph);
+        for (uint64_t v : {uint64_t(enum_to_underlying(
+                               graph->getRuntime()->getDevice())),
+                           kCacheVersion})
+            key = (key ^ v) * 0x100000001b3ull;
+        return key;
+    }
+
+    string GraphCache::getPath(uint64_t key, const string &ext) const
+    {
+        char name[17];
+        snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+        return dir + "/" + name + ext;
+    }
+
+    bool GraphCache::contains(uint64_t key) const
+    {
+        // the plan is committed last
+        return std::filesystem::exists(getPath(key, ".plan"));
+    }
+
+    Graph GraphCache::compile(const Graph &graph, bool tune)
+    {
+        auto key = getKey(graph);
+        if (contains(key))
+        {
+            try
+            {
+                auto compiled = load(key, graph);
+                ++hits;
+                return compiled;
+            }
+            catch (const Exception &e)
+            {
+                std::cerr << "Ignoring graph cache entry "
+                          << getPath(key, ".plan") << ": " << e.what()
+                          << std::endl;
+            }
+        }
+        ++misses;
+        std::unordered_map<TensorObj *, size_t> sourceIndex;
+        for (auto &t : graph->getTensors())
+            sourceIndex.emplace(t.get(), sourceIndex.size());
+        graph->optimize();
+        graph->shape_infer();
+        graph->dataMalloc();
+        if (tune)
+            graph->getRuntime()->tune(graph);
+        store(key, graph, sourceIndex, tune);
+        return graph;
+    }
+
+    void GraphCache::store(
+        uint64_t key, const Graph &compiled,
+        const std::unordered_map<TensorObj *, size_t> &sourceIndex,
+        bool tuned) const
+    {
+        writeFile(getPath(key, ".itg"), [&](const string &tmp)
+                  { saveGraph(compiled, tmp, false); });
+        if (tuned)
+            writeFile(getPath(key, ".kernels"), [&](const string &tmp)
+                      { compiled->getRuntime()->getTuner().save(tmp); });
+
+        // Placements are saved by tensor index, since fuids differ between
+        // processes; workspaces by step and tensors bound outside the arena
+        // by source index.
+        auto &plan = compiled->getMemoryPlan();
+        auto &tensors = compiled->getTensors();
+        std::unordered_map<UidBaseType, size_t> index;
+        for (auto &t : tensors)
+            index.emplace(t->getFuid(), index.size());
+        auto planPath = getPath(key, ".plan");
+        writeFile(planPath, [&](const string &tmp)
+        {
+            std::ofstream ofs(tmp, std::ios::trunc);
+            IT_ASSERT(ofs.is_open(), "Can not open " + planPath);
+            ofs << "steps " << plan.getSteps() << "\n"
+                << "peak " << plan.getPeak() << "\n";
+            std::unordered_set<UidBaseType> placed;
+            for (auto &p : plan.getPlacements())
+            {
+                if (p.isWorkspace())
+                {
+                    ofs << "workspace " << p.firstUse << " " << p.offset << " "
+                        << p.bytes << "\n";
+                    continue;
+                }
+                ofs << "tensor " << index.at(p.fuid) << " " << p.offset << " "
+                    << p.bytes << " " << p.firstUse << " " << p.lastUse << " "
+                    << p.producer << "\n";
+                placed.insert(p.fuid);
+            }
+            for (size_t i = 0; i < tensors.size(); ++i)
+                if (!placed.count(tensors[i]->getFuid()))
+                    ofs << "weight " << i << " "
+                        << sourceIndex.at(tensors[i].get()) << "\n";
+            ofs.close();
+            IT_ASSERT(!ofs.fail(), "Failed to write " + planPath);
+        });
+    }
+
+    Graph GraphCache::load(uint64_t key, const Graph &source) const
+    {
+        auto runtime = source->getRuntime();
+        auto compiled = loadGraph(getPath(key, ".itg"), runtime);
+        auto &tensors = compiled->getTensors();
+        auto &sourceTensors = source->getTensors();
+
+        std::ifstream ifs(getPath(key, ".plan"));
+        IT_ASSERT(ifs.is_open(), "Can not open " + getPath(key, ".plan"));
+        MemoryPlan plan;
+        // weights of `source` without data, and their copies
+        vector<pair<Tensor, Tensor>> unbound;
+        string line;
+        while (std::getline(ifs, line))
+        {
+            std::istringstream iss(line);
+            string kind;
+            iss >> kind;
+            if (kind == "steps")
+            {
+                int steps;
+                iss >> steps;
+                plan = MemoryPlan(steps);
+            }
+            else if (kind == "peak")
+            {
+                size_t peak;
+                iss >> peak;
+                plan.setPeak(peak);
+            }
+            else if (kind == "tensor")
+            {
+                size_t i;
+                TensorPlacement p;
+                iss >> i >> p.offset >> p.bytes >> p.firstUse >> p.lastUse >>
+                    p.producer;
+                IT_ASSERT(!iss.fail() && i < tensors.size(),
+                          "Malformed memory plan");
+                p.fuid = tensors[i]->getFuid();
+                p.guid = tensors[i]->getGuid();
+                plan.add(p);
+            }
+            else if (kind == "workspace")
+            {
+                auto &ops = compiled->getOperators();
+                TensorPlacement p{kWorkspaceFuid};
+                iss >> p.firstUse >> p.offset >> p.bytes;
+                IT_ASSERT(!iss.fail() && p.firstUse >= 0 &&
+                              p.firstUse < (int)ops.size(),
+                          "Malformed memory plan");
+                auto &op = ops[p.firstUse];
+                p.lastUse = p.firstUse;
+                p.guid = op->getGuid();
+                p.producer = string(op->getOpType().toString()) + "[" +
+                             std::to_string(p.guid) + "].workspace";
+                plan.add(p);
+            }
+            else if (kind == "weight")
+            {
+                size_t i, j;
+                iss >> i >> j;
+                IT_ASSERT(!iss.fail() && i < tensors.size() &&
+                              j < sourceTensors.size(),
+                          "Malformed memory plan");
+                auto &tensor = tensors[i], &sourceTensor = sourceTensors[j];
+                IT_ASSERT(sourceTensor->getDType() == tensor->getDType() &&
+                              sourceTensor->getDims() == tensor->getDims() &&
+                              (sourceTensor->hasData() ||
+                               (sourceTensor->isWeight() && tensor->isWeight())),
+                          "Weights do not match the cached graph");
+                if (sourceTensor->hasData())
+                    tensor->setDataBlob(sourceTensor->getDataBlob());
+                else
+                    unbound.emplace_back(sourceTensor, tensor);
+            }
+            else
+                IT_ASSERT(false, "Malformed memory plan");
+        }
+        compiled->dataMalloc(plan);
+        // weights given data later are written through the source graph
+        for (auto &[sourceTensor, tensor] : unbound)
+            sourceTensor->setDataBlob(tensor->getDataBlob());
+
+        auto kernelPath = getPath(key, ".kernels");
+        if (std::filesystem::exists(kernelPath))
+            runtime->getTuner().load(kernelPath);
+        return compiled;
+    }
+
+} // namespace infini
@@ -0,0 +1,123 @@
+#include "core/graph_topology.h"
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+namespace infini
+{
+
+    namespace
+    {
+        // builds CSR arrays from the number of edges of each node and a
+        // callback emitting them
+        template <typename F>
+        void buildCsr(size_t n, vector<int> &offsets, vector<int> &ids,
+                      F forEachEdge)
+        {
+            offsets.assign(n + 1, 0);
+            forEachEdge([&](int from, int) { ++offsets[from + 1]; });
+            for (size_t i = 0; i < n; ++i)
+                offsets[i + 1] += offsets[i];
+            ids.resize(offsets[n]);
+            vector<int> fill(offsets.begin(), offsets.end() - 1);
+            forEachEdge([&](int from, int to) { ids[fill[from]++] = to; });
+        }
+    } // namespace
+
+    GraphTopology::GraphTopology(const OpVec &ops, const TensorVec &tensors)
+    {
+        this->ops.reserve(ops.size());
+        for (auto &op : ops)
+            this->ops.emplace_back(op.get());
+        this->tensors.reserve(tensors.size());
+        tensorIds.reserve(tensors.size());
+        for (auto &tensor : tensors)
+        {
+            tensorIds.emplace(tensor.get(), this->tensors.size());
+            this->tensors.emplace_back(tensor.get());
+        }
+        int nOps = ops.size(), nTensors = tensors.size();
+
+        auto forEachTensor = [&](bool outputs, auto &&emit)
+        {
+            for (int op = 0; op < nOps; ++op)
+                for (auto &t : outputs ? ops[op]->getOutputs()
+                                       : ops[op]->getInputs())
+                    if (int id = t ? getTensorId(t.get()) : -1; id >= 0)
+                        emit(op, id);
+        };
+        buildCsr(nOps, inputOffsets, inputIds,
+                 [&](auto &&emit) { forEachTensor(false, emit); });
+        buildCsr(nOps, outputOffsets, outputIds,
+                 [&](auto &&emit) { forEachTensor(true, emit); });
+
+        sources.assign(nTensors, -1);
+        for (int op = 0; op < nOps; ++op)
+            for (int t : getOutputs(op))
+                sources[t] = op;
+        buildCsr(nTensors, targetOffsets, targetIds,
+                 [&](auto &&emit)
+                 {
+                     for (int op = 0; op < nOps; ++op)
+                         for (int t : getInputs(op))
+                             emit(t, op);
+                 });
+
+        // an operator reading a tensor twice depends on its source once
+        auto forEachDependency = [&](auto &&emit)
+        {
+            for (int op = 0; op < nOps; ++op)
+            {
+                auto inputs = getInputs(op);
+                for (auto it = inputs.begin(); it != inputs.end(); ++it)
+                    if (sources[*it] >= 0 &&
+                        std::find(inputs.begin(), it, *it) == it)
+                        emit(op, sources[*it]);
+            }
+        };
+        buildCsr(nOps, predOffsets, predIds, forEachDependency);
+        buildCsr(nOps, succOffsets, succIds,
+                 [&](auto &&emit)
+                 {
+                     forEachDependency([&](int op, int pred)
+                                       { emit(pred, op); });
+                 });
+    }
+
+    int GraphTopology::getTensorId(const TensorObj *tensor) const
+    {
+        auto it = tensorIds.find(tensor);
+        return it == tensorIds.end() ? -1 : it->second;
+    }
+
+    vector<int> GraphTopology::topoOrder() const
+    {
+        int nOps = ops.size();
+        vector<int> pending(nOps), order;
+        order.reserve(nOps);
+        std::priority_queue<int, vector<int>, std::greater<int>> ready;
+        for (int op = 0; op < nOps; ++op)
+            if ((pending[op] = getPredecessors(op).size()) == 0)
+                ready.push(op);
+        while (!ready.empty())
+        {
+            int op = ready.top();
+            ready.pop();
+            order.emplace_back(op);
+            for (int succ : getSuccessors(op))
+                if (--pending[succ] == 0)
+                    ready.push(succ);
+        }
+        return order;
+    }
+
+    vector<int> GraphTopology::lastUses() const
+    {
+        vector<int> last(tensors.size(), -1);
+        for (size_t t = 0; t < tensors.size(); ++t)
+            for (int op : getTargets(t))
+                last[t] = std::max(last[t], op);
+        return last;
+    }
+
+} // namespace infini
@@ -0,0 +1,148 @@
+#include "core/memory_plan.h"
+#include <algorithm>
+#include <fstream>
+
+namespace infini
+{
+
+    vector<size_t> MemoryPlan::getLiveBytes() const
+    {
+        // difference array over steps
+        vector<long long> delta(std::max(steps, 1) + 1, 0);
+        for (auto &p : placements)
+        {
+            delta[p.firstUse] += p.bytes;
+            delta[p.lastUse + 1] -= p.bytes;
+        }
+        vector<size_t> live(std::max(steps, 1));
+        long long sum = 0;
+        for (size_t s = 0; s < live.size(); ++s)
+            live[s] = sum += delta[s];
+        return live;
+    }
+
+    size_t MemoryPlan::getLowerBound() const
+    {
+        auto live = getLiveBytes();
+        return *std::max_element(live.begin(), live.end());
+    }
+
+    int MemoryPlan::getPeakStep() const
+    {
+        // sweep the steps, keeping the block ends of live tensors
+        int nSteps = std::max(steps, 1);
+        vector<vector<const TensorPlacement *>> begins(nSteps), ends(nSteps);
+        for (auto &p : placements)
+        {
+            begins[p.firstUse].emplace_back(&p);
+            ends[p.lastUse].emplace_back(&p);
+        }
+        std::multiset<size_t> live;
+        size_t best = 0;
+        int bestStep = 0;
+        for (int s = 0; s < nSteps; ++s)
+        {
+            for (auto p : begins[s])
+                live.insert(p->offset + p->bytes);
+            if (!live.empty() && *live.rbegin() > best)
+            {
+                best = *live.rbegin();
+                bestStep = s;
+            }
+            for (auto p : ends[s])
+                live.erase(live.find(p->offset + p->bytes));
+        }
+        return bestStep;
+    }
+
+    size_t MemoryPlan::getWastedAtPeak() const
+    {
+        int step = getPeakStep();
+        size_t highWater = 0, live = 0;
+        for (auto &p : placements)
+            if (p.firstUse <= step && step <= p.lastUse)
+            {
+                highWater = std::max(highWater, p.offset + p.bytes);
+                live += p.bytes;
+            }
+        return highWater - live;
+    }
+
+    vector<TensorPlacement> MemoryPlan::getPeakTensors() const
+    {
+        int step = getPeakStep();
+        vector<TensorPlacement> ret;
+        for (auto &p : placements)
+            if (p.firstUse <= step && step <= p.lastUse)
+                ret.emplace_back(p);
+        std::sort(ret.begin(), ret.end(),
+                  [](auto &a, auto &b) { return a.bytes > b.bytes; });
+        return ret;
+    }
+
+    string MemoryPlan::summary() const
+    {
+        auto lowerBound = getLowerBound();
+        std::ostringstream oss;
+        oss << "Memory plan: " << placements.size() << " tensors, " << steps
+            << " steps, arena " << peak << " bytes, lower bound " << lowerBound
+            << " bytes";
+        if (lowerBound > 0)
+            oss << " (" << (double)peak / lowerBound << "x)";
+        oss << ", wasted at peak step " << getPeakStep() << ": "
+            << getWastedAtPeak() << " bytes\n";
+        auto top = getPeakTensors();
+        top.resize(std::min<size_t>(top.size(), 10));
+        for (auto &p : top)
+            oss << "  fuid " << p.fuid << ", " << p.bytes << " bytes at "
+                << p.offset << ", steps [" << p.firstUse << "," << p.lastUse
+                << "], " << p.producer << "\n";
+        return oss.str();
+    }
+
+    string MemoryPlan::toJson() const
+    {
+        std::ostringstream oss;
+        oss << "{\"steps\":" << steps << ",\"peak\":" << peak
+            << ",\"lower_bound\":" << getLowerBound()
+            << ",\"peak_step\":" << getPeakStep()
+            << ",\"wasted_at_peak\":" << getWastedAtPeak() << ",\"tensors\":[";
+        for (size_t i = 0; i < placements.size(); ++i)
+        {
+            auto &p = placements[i];
+            oss << (i ? ",\n" : "\n") << "{\"fuid\":" << p.fuid
+                << ",\"guid\":" << p.guid << ",\"offset\":" << p.offset
+                << ",\"bytes\":" << p.bytes << ",\"first_use\":" << p.firstUse
+                << ",\"last_use\":" << p.lastUse << ",\"producer\":\""
+                << p.producer << "\"}";
+        }
+        oss << "\n]}\n";
+        return oss.str();
+    }
+
+    string MemoryPlan::toCsv() const
+    {
+        std::ostringstream oss;
+        oss << "fuid,guid,offset,bytes,first_use,last_use,producer\n";
+        for (auto &p : placements)
+            oss << p.fuid << "," << p.guid << "," << p.offset << "," << p.bytes
+                << "," << p.firstUse << "," << p.lastUse << "," << p.producer
+                << "\n";
+        return oss.str();
+    }
+
+    void MemoryPlan::exportJson(const string &path) const
+    {
+        std::ofstream ofs(path);
+        IT_ASSERT(ofs.is_open(), "Can not open " + path);
+        ofs << toJson();
+    }
+
+    void MemoryPlan::exportCsv(const string &path) const
+    {
+        std::ofstream ofs(path);
+        IT_ASSERT(ofs.is_open(), "Can not open " + path);
+        ofs << toCsv();
+    }
+
+} // namespace infini
@@ -0,0 +1,146 @@
+#include "core/numa.h"
+#include <algorithm>
+#include <dirent.h>
+#include <fstream>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace infini
+{
+
+    namespace
+    {
+        // from <numaif.h>, which needs libnuma
+        constexpr int kMpolBind = 2;
+        constexpr unsigned kMpolMfMove = 1 << 1;
+
+        vector<NumaNode> detectNodes()
+        {
+            vector<NumaNode> nodes;
+            const string root = "/sys/devices/system/node";
+            if (DIR *dir = opendir(root.c_str()))
+            {
+                while (auto entry = readdir(dir))
+                {
+                    string name = entry->d_name;
+                    if (name.rfind("node", 0) != 0 || name.size() == 4 ||
+                        !std::all_of(name.begin() + 4, name.end(), ::isdigit))
+                        continue;
+                    std::ifstream ifs(root + "/" + name + "/cpulist");
+                    string list;
+                    if (!std::getline(ifs, list))
+                        continue;
+                    auto cpus = NumaTopology::parseCpuList(list);
+                    if (!cpus.empty())
+                        nodes.push_back({std::stoi(name.substr(4)), cpus});
+                }
+                closedir(dir);
+            }
+            if (nodes.empty())
+            {
+                vector<int> cpus(std::max(1L, sysconf(_SC_NPROCESSORS_ONLN)));
+                for (size_t i = 0; i < cpus.size(); ++i)
+                    cpus[i] = i;
+                nodes.push_back({0, cpus});
+            }
+            return nodes;
+        }
+    } // namespace
+
+    NumaTopology::NumaTopology(vector<NumaNode> nodes) : nodes(std::move(nodes))
+    {
+        IT_ASSERT(!this->nodes.empty());
+        std::sort(this->nodes.begin(), this->nodes.end(),
+                  [](auto &a, auto &b) { return a.id < b.id; });
+    }
+
+    const NumaTopology &NumaTopology::get()
+    {
+        static NumaTopology topology(detectNodes());
+        return topology;
+    }
+
+    vector<int> NumaTopology::getCpus(Affinity affinity, int node) const
+    {
+        vector<const NumaNode *> selected;
+        for (auto &n : nodes)
+            if (node < 0 || n.id == node)
+                selected.emplace_back(&n);
+        IT_ASSERT(!selected.empty(), "No NUMA node " + std::to_string(node));
+        vector<int> cpus;
+        switch (affinity)
+        {
+        case Affinity::None:
+            break;
+        case Affinity::Compact:
+            for (auto n : selected)
+                cpus.insert(cpus.end(), n->cpus.begin(), n->cpus.end());
+            break;
+        case Affinity::Scatter:
+            for (size_t i = 0;; ++i)
+            {
+                size_t added = 0;
+                for (auto n : selected)
+                    if (i < n->cpus.size())
+                    {
+                        cpus.emplace_back(n->cpus[i]);
+                        ++added;
+                    }
+                if (added == 0)
+                    break;
+            }
+            break;
+        }
+        return cpus;
+    }
+
+    string NumaTopology::toString() const
+    {
+        std::ostringstream oss;
+        oss << nodes.size() << " NUMA node(s)";
+        for (auto &n : nodes)
+            oss << "\n  node " << n.id << ": " << n.cpus.size() << " CPUs "
+                << vecToString(n.cpus);
+        return oss.str();
+    }
+
+    vector<int> NumaTopology::parseCpuList(const string &list)
+    {
+        vector<int> cpus;
+        std::istringstream iss(list);
+        string range;
+        while (std::getline(iss, range, ','))
+        {
+            if (range.empty() || !isdigit(range[0]))
+                continue;
+            auto dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last =
+                dash == string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu)
+                cpus.emplace_back(cpu);
+        }
+        return cpus;
+    }
+
+    bool pinThread(const vector<int> &cpus)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (auto cpu : cpus)
+            if (cpu >= 0 && cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &set);
+        return sched_setaffinity(0, sizeof(set), &set) == 0;
+    }
+
+    bool bindMemory(void *ptr, size_t size, int node)
+    {
+        constexpr size_t kBits = 8 * sizeof(unsigned long);
+        vector<unsigned long> mask(node / kBits + 1, 0);
+        mask[node / kBits] = 1ul << (node % kBits);
+        return syscall(SYS_mbind, ptr, size, kMpolBind, mask.data(),
+                       mask.size() * kBits + 1, kMpolMfMove) == 0;
+    }
+
+} // namespace infini
@@ -0,0 +1,730 @@
+#include "core/onnx.h"
+#include "core/blob.h"
+#include "core/runtime.h"
+#include "core/serializer.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include <fstream>
+#include <string_view>
+
+namespace infini
+{
+
+    namespace
+    {
+        /**
+         * @brief Decodes the protobuf wire format, one field at a time.
+         */
+        class ProtoReader
+        {
+            const uint8_t *p, *end;
+
+        public:
+            uint32_t field = 0, wire = 0;
+
+            explicit ProtoReader(std::string_view buf)
+                : p(reinterpret_cast<const uint8_t *>(buf.data())),
+                  end(p + buf.size()) {}
+
+            bool next()
+            {
+                if (p == end)
+                    return false;
+                auto key = varint();
+                field = key >> 3;
+                wire = key & 7;
+                return true;
+            }
+
+            uint64_t varint()
+            {
+                uint64_t val = 0;
+                for (int shift = 0;; shift += 7)
+                {
+                    IT_ASSERT(p < end && shift < 64, "Malformed ONNX model");
+                    uint8_t byte = *p++;
+                    val |= uint64_t(byte & 0x7f) << shift;
+                    if (!(byte & 0x80))
+                        return val;
+                }
+            }
+
+            std::string_view bytes()
+            {
+                IT_ASSERT(wire == 2, "Malformed ONNX model");
+                auto size = varint();
+                IT_ASSERT(size <= size_t(end - p), "Malformed ONNX model");
+                std::string_view ret(reinterpret_cast<const char *>(p), size);
+                p += size;
+                return ret;
+            }
+
+            string str() { return string(bytes()); }
+
+            template <typename T>
+            T fixed()
+            {
+                IT_ASSERT(sizeof(T) <= size_t(end - p), "Malformed ONNX model");
+                T val;
+                std::memcpy(&val, p, sizeof(T));
+                p += sizeof(T);
+                return val;
+            }
+
+            void skip()
+            {
+                switch (wire)
+                {
+                case 0:
+                    varint();
+                    break;
+                case 1:
+                    fixed<uint64_t>();
+                    break;
+                case 2:
+                    bytes();
+                    break;
+                case 5:
+                    fixed<uint32_t>();
+                    break;
+                default:
+                    IT_ASSERT(false, "Malformed ONNX model");
+                }
+            }
+
+            // Repeated scalars may be packed or not.
+            void ints(vector<int64_t> &out)
+            {
+                if (wire != 2)
+                {
+                    out.emplace_back(varint());
+                    return;
+                }
+                ProtoReader packed(bytes());
+                while (packed.p != packed.end)
+                    out.emplace_back(packed.varint());
+            }
+
+            template <typename T>
+            void reals(vector<T> &out)
+            {
+                if (wire != 2)
+                {
+                    out.emplace_back(fixed<T>());
+                    return;
+                }
+                auto buf = bytes();
+                IT_ASSERT(buf.size() % sizeof(T) == 0, "Malformed ONNX model");
+                auto n = out.size();
+                out.resize(n + buf.size() / sizeof(T));
+                std::memcpy(out.data() + n, buf.data(), buf.size());
+            }
+        };
+
+        struct OnnxTensor
+        {
+            string name;
+            vector<int64_t> dims;
+            int dataType = 0;
+            std::string_view raw;
+            vector<float> floats;
+            vector<double> doubles;
+            vector<int64_t> ints; // int32_data, int64_data and uint64_data
+            bool external = false;
+            std::map<string, string> externalData;
+        };
+
+        struct OnnxAttr
+        {
+            float f = 0;
+            int64_t i = 0;
+            vector<float> floats;
+            vector<int64_t> ints;
+        };
+
+        struct OnnxNode
+        {
+            vector<string> inputs, outputs;
+            string opType, domain;
+            std::map<string, OnnxAttr> attrs;
+        };
+
+        struct OnnxValueInfo
+        {
+            string name;
+            int elemType = 0;
+            vector<int64_t> dims;
+            bool symbolic = false; // some dim has no value
+        };
+
+        struct OnnxGraph
+        {
+            vector<OnnxNode> nodes;
+            vector<OnnxTensor> initializers;
+            vector<OnnxValueInfo> inputs;
+        };
+
+        OnnxTensor parseTensor(std::string_view buf)
+        {
+            OnnxTensor t;
+            ProtoReader r(buf);
+            while (r.next())
+                switch (r.field)
+                {
+                case 1:
+                    r.ints(t.dims);
+                    break;
+                case 2:
+                    t.dataType = r.varint();
+                    break;
+                case 4:
+                    r.reals(t.floats);
+                    break;
+                case 5:
+                case 7:
+                case 11:
+                    r.ints(t.ints);
+                    break;
+                case 8:
+                    t.name = r.str();
+                    break;
+                case 9:
+                    t.raw = r.bytes();
+                    break;
+                case 10:
+                    r.reals(t.doubles);
+                    break;
+                case 13:
+                {
+                    string key, value;
+                    ProtoReader entry(r.bytes());
+                    while (entry.next())
+                        if (entry.field == 1)
+                            key = entry.str();
+                        else if (entry.field == 2)
+                            value = entry.str();
+                        else
+                            entry.skip();
+                    t.externalData[key] = value;
+                    break;
+                }
+                case 14:
+                    t.external = r.varint() == 1;
+                    break;
+                default:
+                    r.skip();
+                }
+            return t;
+        }
+
+        std::pair<string, OnnxAttr> parseAttr(std::string_view buf)
+        {
+            string name;
+            OnnxAttr attr;
+            ProtoReader r(buf);
+            while (r.next())
+                switch (r.field)
+                {
+                case 1:
+                    name = r.str();
+                    break;
+                case 2:
+                    attr.f = r.fixed<float>();
+                    break;
+                case 3:
+                    attr.i = r.varint();
+                    break;
+                case 7:
+                    r.reals(attr.floats);
+                    break;
+                case 8:
+                    r.ints(attr.ints);
+                    break;
+                default:
+                    r.skip();
+                }
+            return {name, attr};
+        }
+
+        OnnxNode parseNode(std::string_view buf)
+        {
+            OnnxNode node;
+            ProtoReader r(buf);
+            while (r.next())
+                switch (r.field)
+                {
+                case 1:
+                    node.inputs.emplace_back(r.str());
+                    break;
+                case 2:
+                    node.outputs.emplace_back(r.str());
+                    break;
+                case 4:
+                    node.opType = r.str();
+                    break;
+                case 5:
+                    node.attrs.insert(parseAttr(r.bytes()));
+                    break;
+                case 7:
+                    node.domain = r.str();
+                    break;
+                default:
+                    r.skip();
+                }
+            return node;
+        }
+
+        // ValueInfoProto -> TypeProto -> TypeProto.Tensor -> TensorShapeProto
+        OnnxValueInfo parseValueInfo(std::string_view buf)
+        {
+            OnnxValueInfo info;
+            ProtoReader r(buf);
+            while (r.next())
+            {
+                if (r.field == 1)
+                {
+                    info.name = r.str();
+                    continue;
+                }
+                if (r.field != 2)
+                {
+                    r.skip();
+                    continue;
+                }
+                ProtoReader type(r.bytes());
+                while (type.next())
+                {
+                    if (type.field != 1)
+                    {
+                        type.skip();
+                        continue;
+                    }
+                    ProtoReader tensor(type.bytes());
+                    while (tensor.next())
+                    {
+                        if (tensor.field == 1)
+                        {
+                            info.elemType = tensor.varint();
+                            continue;
+                        }
+                        if (tensor.field != 2)
+                        {
+                            tensor.skip();
+                            continue;
+                        }
+                        ProtoReader shape(tensor.bytes());
+                        while (shape.next())
+                        {
+                            if (shape.field != 1)
+                            {
+                                shape.skip();
+                                continue;
+                            }
+                            ProtoReader dim(shape.bytes());
+                            bool hasValue = false;
+                            while (dim.next())
+                                if (dim.field == 1)
+                                {
+                                    info.dims.emplace_back(dim.varint());
+                                    hasValue = true;
+                                }
+                                else
+                                    dim.skip();
+                            if (!hasValue)
+                            {
+                                info.dims.emplace_back(-1);
+                                info.symbolic = true;
+                            }
+                        }
+                    }
+                }
+            }
+            return info;
+        }
+
+        OnnxGraph parseModel(std::string_view buf)
+        {
+            OnnxGraph graph;
+            bool hasGraph = false;
+            ProtoReader model(buf);
+            while (model.next())
+            {
+                if (model.field != 7)
+                {
+                    model.skip();
+                    continue;
+                }
+                hasGraph = true;
+                ProtoReader r(model.bytes());
+                while (r.next())
+                    switch (r.field)
+                    {
+                    case 1:
+                        graph.nodes.emplace_back(parseNode(r.bytes()));
+                        break;
+                    case 5:
+                        graph.initializers.emplace_back(parseTensor(r.bytes()));
+                        break;
+                    case 11:
+                        graph.inputs.emplace_back(parseValueInfo(r.bytes()));
+                        break;
+                    default:
+                        r.skip();
+                    }
+            }
+            IT_ASSERT(hasGraph, "ONNX model has no graph");
+            return graph;
+        }
+
+        Shape toShape(const vector<int64_t> &dims)
+        {
+            Shape shape;
+            for (auto d : dims)
+            {
+                IT_ASSERT(d >= 0 && d <= std::numeric_limits<int>::max(),
+                          "Unsupported ONNX dim " + std::to_string(d));
+                shape.emplace_back(d);
+            }
+            return shape;
+        }
+
+        // ONNX numbers its element types the way DataType does.
+        DataType toDataType(int64_t type)
+        {
+            IT_ASSERT(type > 0 && type < int64_t(std::size(DataType::names)) &&
+                          DataType::sizePerElement[type] > 0,
+                      "Unsupported ONNX data type " + std::to_string(type));
+            return DataType(type);
+        }
+
+        // Widths other than the element size are truncated little-endian.
+        template <typename T>
+        void copyElements(const vector<T> &vals, char *dst, size_t bytes,
+                          size_t elemSize)
+        {
+            IT_ASSERT(vals.size() * elemSize == bytes,
+                      "ONNX initializer size mismatch");
+            for (size_t i = 0; i < vals.size(); ++i)
+                std::memcpy(dst + i * elemSize, &vals[i],
+                            std::min(sizeof(T), elemSize));
+        }
+
+        /**
+         * @brief Reads an external-data initializer in fixed-size chunks
+         * straight into `dst`.
+         */
+        void readExternal(const OnnxTensor &t, const string &dir, char *dst,
+                          size_t bytes)
+        {
+            auto &info = t.externalData;
+            auto location = info.find("location");
+            IT_ASSERT(location != info.end(),
+                      "External initializer " + t.name + " has no location");
+            auto path = dir.empty() ? location->second
+                                    : dir + "/" + location->second;
+            size_t offset = 0;
+            if (auto it = info.find("offset"); it != info.end())
+                offset = std::stoull(it->second);
+            if (auto it = info.find("length"); it != info.end())
+                IT_ASSERT(std::stoull(it->second) == bytes,
+                          "ONNX initializer size mismatch for " + t.name);
+
+            std::ifstream ifs(path, std::ios::binary);
+            IT_ASSERT(ifs.is_open(), "Can not open " + path);
+            ifs.seekg(offset);
+            constexpr size_t kChunk = 1 << 20;
+            for (size_t done = 0; done < bytes; done += kChunk)
+            {
+                auto n = std::min(kChunk, bytes - done);
+                ifs.read(dst + done, n);
+                IT_ASSERT(size_t(ifs.gcount()) == n,
+                          "Truncated external data in " + path);
+            }
+        }
+
+        void readInitializer(const OnnxTensor &t, const string &dir,
+                             DataType dtype, char *dst, size_t bytes)
+        {
+            if (t.external)
+                readExternal(t, dir, dst, bytes);
+            else if (!t.raw.empty() || bytes == 0)
+            {
+                IT_ASSERT(t.raw.size() == bytes,
+                          "ONNX initializer size mismatch for " + t.name);
+                std::memcpy(dst, t.raw.data(), bytes);
+            }
+            else if (!t.floats.empty())
+                copyElements(t.floats, dst, bytes, dtype.getSize());
+            else if (!t.doubles.empty())
+                copyElements(t.doubles, dst, bytes, dtype.getSize());
+            else
+                copyElements(t.ints, dst, bytes, dtype.getSize());
+        }
+
+        struct CastRule
+        {
+            DataType from, to;
+            CastType type;
+        };
+
+        const CastRule kCastRules[] = {
+            {DataType::Float32, DataType::Float16, CastType::Float2Float16},
+            {DataType::Float32, DataType::Int64, CastType::Float2Int64},
+            {DataType::Float32, DataType::Int32, CastType::Float2Int32},
+            {DataType::Float32, DataType::Int16, CastType::Float2Int16},
+            {DataType::Float32, DataType::Int8, CastType::Float2Int8},
+            {DataType::Float32, DataType::BFloat16, CastType::Float2BFloat16},
+            {DataType::Float32, DataType::Float32, CastType::Float2Float},
+            {DataType::Int32, DataType::Float32, CastType::Int322Float},
+            {DataType::Int32, DataType::Int8, CastType::Int322Int8},
+            {DataType::Int32, DataType::Int16, CastType::Int322Int16},
+            {DataType::Int32, DataType::Int64, CastType::Int322Int64},
+            {DataType::Int16, DataType::Float32, CastType::Int162Float},
+            {DataType::Int16, DataType::Int32, CastType::Int162Int32},
+            {DataType::Int8, DataType::Float32, CastType::Int82Float},
+            {DataType::Int8, DataType::Int16, CastType::Int82Int16},
+            {DataType::Int8, DataType::Int32, CastType::Int82Int32},
+            {DataType::UInt8, DataType::Float32, CastType::Uint82Float},
+            {DataType::UInt8, DataType::Int32, CastType::Uint82Int32},
+            {DataType::UInt8, DataType::Int64, CastType::Uint82Int64},
+            {DataType::Int64, DataType::Int32, CastType::Int642Int32},
+            {DataType::Int64, DataType::UInt32, CastType::Int642Uint32},
+            {DataType::Int64, DataType::Float32, CastType::Int642Float},
+            {DataType::UInt32, DataType::Int64, CastType::Uint322Int64},
+            {DataType::Float16, DataType::Float32, CastType::Float162Float},
+            {DataType::BFloat16, DataType::Float32, CastType::BFloat162Float},
+        };
+
+        class Importer
+        {
+            GraphObj *g;
+            Runtime runtime;
+            string dir;
+            std::unordered_map<string, const OnnxTensor *> initializers;
+            std::unordered_map<string, Tensor> tensors;
+            vector<pair<Tensor, const OnnxTensor *>> weights;
+
+        public:
+            Importer(GraphObj *g, Runtime runtime, string dir)
+                : g(g), runtime(std::move(runtime)), dir(std::move(dir)) {}
+
+            void import(const OnnxGraph &model,
+                        const std::map<string, Shape> &inputShapes)
+            {
+                for (auto &t : model.initializers)
+                    initializers[t.name] = &t;
+                for (auto &info : model.inputs)
+                {
+                    // old exporters list initializers as inputs too
+                    if (initializers.count(info.name))
+                        continue;
+                    Shape shape;
+                    if (auto it = inputShapes.find(info.name);
+                        it != inputShapes.end())
+                        shape = it->second;
+                    else
+                    {
+                        IT_ASSERT(!info.symbolic, "Input " + info.name +
+                                                      " has symbolic dims, "
+                                                      "its shape must be given");
+                        shape = toShape(info.dims);
+                    }
+                    auto t = g->addTensor(shape, toDataType(info.elemType));
+                    t->setInput();
+                    tensors[info.name] = t;
+                }
+                for (auto &node : model.nodes)
+                    addNode(node);
+                bindWeights();
+            }
+
+        private:
+            Tensor getTensor(const string &name)
+            {
+                if (auto it = tensors.find(name); it != tensors.end())
+                    return it->second;
+                // initializers become tensors only once an operator uses them
+                auto it = initializers.find(name);
+                IT_ASSERT(it != initializers.end(),
+                          "Unknown ONNX tensor " + name);
+                auto t = g->addTensor(toShape(it->second->dims),
+                                      toDataType(it->second->dataType));
+                t->setWeight();
+                weights.emplace_back(t, it->second);
+                return tensors[name] = t;
+            }
+
+            std::optional<float> getScalar(const OnnxNode &node, size_t idx)
+            {
+                if (idx >= node.inputs.size() || node.inputs[idx].empty())
+                    return std::nullopt;
+                auto it = initializers.find(node.inputs[idx]);
+                IT_ASSERT(it != initializers.end(),
+                          "Clip bound " + node.inputs[idx] +
+                              " must be an initializer");
+                IT_ASSERT(it->second->dataType ==
+                              DataType::Float32.getIndex(),
+                          "Clip bound " + node.inputs[idx] + " must be float");
+                float val;
+                readInitializer(*it->second, dir, DataType::Float32,
+                                reinterpret_cast<char *>(&val), sizeof(val));
+                return val;
+            }
+
+            void addNode(const OnnxNode &node)
+            {
+                IT_ASSERT(node.domain.empty() || node.domain == "ai.onnx",
+                          "Unsupported ONNX domain " + node.domain);
+                auto &type = node.opType;
+                auto &attrs = node.attrs;
+                auto attrInt = [&](const string &name, int64_t dflt)
+                {
+                    auto it = attrs.find(name);
+                    return it == attrs.end() ? dflt : it->second.i;
+                };
+                auto input = [&](size_t idx)
+                {
+                    IT_ASSERT(idx < node.inputs.size(),
+                              type + " has too few inputs");
+                    return getTensor(node.inputs[idx]);
+                };
+                IT_ASSERT(node.outputs.size() == 1,
+                          type + " must have exactly one output");
+
+                Tensor output;
+                if (type == "MatMul")
+                    output = g->addOp<MatmulObj>(input(0), input(1), nullptr)
+                                 ->getOutput();
+                else if (type == "Gemm")
+                {
+                    auto alpha = attrs.count("alpha") ? attrs.at("alpha").f : 1;
+                    auto beta = attrs.count("beta") ? attrs.at("beta").f : 1;
+                    IT_ASSERT(alpha == 1 && beta == 1,
+                              "Gemm supports only alpha = beta = 1");
+                    output = g->addOp<MatmulObj>(input(0), input(1), nullptr,
+                                                 attrInt("transA", 0),
+                                                 attrInt("transB", 0))
+                                 ->getOutput();
+                    if (node.inputs.size() > 2 && !node.inputs[2].empty())
+                        output = g->addOp<AddObj>(output, input(2), nullptr)
+                                     ->getOutput();
+                }
+                else if (type == "Transpose")
+                {
+                    auto x = input(0);
+                    vector<int> perm;
+                    if (auto it = attrs.find("perm"); it != attrs.end())
+                        perm.assign(it->second.ints.begin(),
+                                    it->second.ints.end());
+                    else
+                        for (int i = x->getRank() - 1; i >= 0; --i)
+                            perm.emplace_back(i);
+                    output = g->addOp<TransposeObj>(x, nullptr, perm)
+                                 ->getOutput();
+                }
+                else if (type == "Concat")
+                {
+                    TensorVec inputs;
+                    for (size_t i = 0; i < node.inputs.size(); ++i)
+                        inputs.emplace_back(input(i));
+                    output = g->addOp<ConcatObj>(inputs, nullptr,
+                                                 attrInt("axis", 0))
+                                 ->getOutput();
+                }
+                else if (type == "Add")
+                    output = g->addOp<AddObj>(input(0), input(1), nullptr)
+                                 ->getOutput();
+                else if (type == "Sub")
+                    output = g->addOp<SubObj>(input(0), input(1), nullptr)
+                                 ->getOutput();
+                else if (type == "Mul")
+                    output = g->addOp<MulObj>(input(0), input(1), nullptr)
+                                 ->getOutput();
+                else if (type == "Div")
+                    output = g->addOp<DivObj>(input(0), input(1), nullptr)
+                                 ->getOutput();
+                else if (type == "Relu")
+                    output = g->addOp<ReluObj>(input(0), nullptr)->getOutput();
+                else if (type == "Clip")
+                {
+                    // attributes before opset 11, optional inputs since
+                    auto min = getScalar(node, 1), max = getScalar(node, 2);
+                    if (auto it = attrs.find("min"); it != attrs.end())
+                        min = it->second.f;
+                    if (auto it = attrs.find("max"); it != attrs.end())
+                        max = it->second.f;
+                    output = g->addOp<ClipObj>(input(0), nullptr, min, max)
+                                 ->getOutput();
+                }
+                else if (type == "Cast")
+                {
+                    auto x = input(0);
+                    auto to = toDataType(attrInt("to", 0));
+                    auto rule = std::find_if(
+                        std::begin(kCastRules), std::end(kCastRules),
+                        [&](auto &r)
+                        { return r.from == x->getDType() && r.to == to; });
+                    IT_ASSERT(rule != std::end(kCastRules),
+                              "Unsupported Cast from " +
+                                  x->getDType().toString() + " to " +
+                                  to.toString());
+                    output = g->addOp<CastObj>(x, nullptr, rule->type)
+                                 ->getOutput();
+                }
+                else
+                    IT_TODO_HALT_MSG("Unsupported ONNX operator " + type);
+                tensors[node.outputs[0]] = output;
+            }
+
+            /**
+             * @brief Copies all used initializers into one buffer owned by
+             * their blobs, each at a multiple of `kWeightAlignment`.
+             */
+            void bindWeights()
+            {
+                vector<size_t> offsets;
+                size_t size = 0;
+                for (auto &[t, _] : weights)
+                {
+                    offsets.emplace_back(size);
+                    size += (t->getBytes() + kWeightAlignment - 1) /
+                            kWeightAlignment * kWeightAlignment;
+                }
+                if (size == 0)
+                    return;
+                auto rt = runtime;
+                Ref<void> owner(rt->alloc(size),
+                                [rt](void *ptr) { rt->dealloc(ptr); });
+                auto base = static_cast<char *>(owner.get());
+                for (size_t i = 0; i < weights.size(); ++i)
+                {
+                    auto &[t, init] = weights[i];
+                    readInitializer(*init, dir, t->getDType(),
+                                    base + offsets[i], t->getBytes());
+                    t->setDataBlob(
+                        make_ref<BlobObj>(runtime, base + offsets[i], owner));
+                }
+            }
+        };
+    } // namespace
+
+    Graph importOnnx(const string &path, Runtime runtime,
+                     const std::map<string, Shape> &inputShapes)
+    {
+        std::ifstream ifs(path, std::ios::binary);
+        IT_ASSERT(ifs.is_open(), "Can not open " + path);
+        string buf((std::istreambuf_iterator<char>(ifs)),
+                   std::istreambuf_iterator<char>());
+        auto model = parseModel(buf);
+
+        auto slash = path.find_last_of('/');
+        string dir = slash == string::npos ? "" : path.substr(0, slash);
+        Graph g = make_ref<GraphObj>(runtime);
+        Importer(g.get(), runtime, dir).import(model, inputShapes);
+        return g;
+    }
+
+} // namespace infini
@@ -0,0 +1,126 @@
+#include "core/profiler.h"
+#include "core/operator.h"
+#include "operators/matmul.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+namespace infini
+{
+
+    void Profiler::record(const Operator &op, const string &kernel,
+                          double begin, double end)
+    {
+        size_t bytesRead = 0, bytesWritten = 0;
+        for (auto &input : op->getInputs())
+            bytesRead += input->getBytes();
+        for (auto &output : op->getOutputs())
+            bytesWritten += output->getBytes();
+        double flops = getFlops(op);
+        std::lock_guard<std::mutex> lock(mutex);
+        int thread = threads.emplace(std::this_thread::get_id(), threads.size())
+                         .first->second;
+        records.push_back({op->getGuid(), op->getOpType(), kernel, begin,
+                           end - begin, bytesRead, bytesWritten, flops,
+                           thread});
+    }
+
+    double Profiler::getFlops(const Operator &op)
+    {
+        if (op->getOpType() == OpType::MatMul)
+        {
+            auto matmul = as<MatmulObj>(op);
+            // size of C is batch * m * n
+            return 2.0 * matmul->getK() * matmul->getOutput()->size();
+        }
+        return 0;
+    }
+
+    vector<OpTypeProfile>
+    Profiler::aggregate(const vector<OpProfile> &records)
+    {
+        std::map<OpType, OpTypeProfile> types;
+        for (auto &r : records)
+        {
+            auto &t = types[r.type];
+            t.type = r.type;
+            t.count++;
+            t.duration += r.duration;
+            t.bytes += r.bytesRead + r.bytesWritten;
+            t.flops += r.flops;
+        }
+        vector<OpTypeProfile> ret;
+        for (auto &[type, t] : types)
+            ret.emplace_back(t);
+        std::sort(ret.begin(), ret.end(), [](auto &a, auto &b)
+                  { return a.duration > b.duration; });
+        return ret;
+    }
+
+    string Profiler::summary() const
+    {
+        auto records = getRecords();
+        double total = 0;
+        for (auto &r : records)
+            total += r.duration;
+        // bytes per us is MB/s, flops per us is MFLOP/s
+        auto rate = [](double amount, double us)
+        { return us > 0 ? amount / us / 1e3 : 0; };
+
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(3);
+        oss << "Profile of " << records.size() << " operator executions, "
+            << total / 1e3 << " ms in total\n";
+        oss << std::left << std::setw(12) << "OpType" << std::right
+            << std::setw(8) << "Count" << std::setw(12) << "Time(ms)"
+            << std::setw(9) << "Pct" << std::setw(12) << "GB/s"
+            << std::setw(12) << "GFLOP/s" << "\n";
+        for (auto &t : aggregate(records))
+            oss << std::left << std::setw(12) << t.type.toString() << std::right
+                << std::setw(8) << t.count << std::setw(12) << t.duration / 1e3
+                << std::setw(8) << (total > 0 ? t.duration / total * 100 : 0)
+                << "%" << std::setw(12) << rate(t.bytes, t.duration)
+                << std::setw(12) << rate(t.flops, t.duration) << "\n";
+
+        vector<const OpProfile *> sorted;
+        for (auto &r : records)
+            sorted.emplace_back(&r);
+        std::stable_sort(sorted.begin(), sorted.end(), [](auto a, auto b)
+                         { return a->duration > b->duration; });
+        oss << std::left << std::setw(8) << "Guid" << std::setw(12) << "OpType"
+            << std::setw(24) << "Kernel" << std::right << std::setw(12)
+            << "Time(ms)" << std::setw(12) << "GB/s" << std::setw(12)
+            << "GFLOP/s" << "\n";
+        for (auto r : sorted)
+            oss << std::left << std::setw(8) << r->guid << std::setw(12)
+                << r->type.toString() << std::setw(24) << r->kernel << std::right
+                << std::setw(12) << r->duration / 1e3 << std::setw(12)
+                << rate(r->bytesRead + r->bytesWritten, r->duration)
+                << std::setw(12) << rate(r->flops, r->duration) << "\n";
+        return oss.str();
+    }
+
+    void Profiler::exportChromeTrace(const string &path) const
+    {
+        std::ofstream ofs(path);
+        IT_ASSERT(ofs.is_open(), "Can not open " + path);
+        auto records = getRecords();
+        ofs << std::fixed << std::setprecision(3);
+        ofs << "{\"traceEvents\":[";
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+            auto &r = records[i];
+            ofs << (i ? ",\n" : "\n") << "{\"name\":\"" << r.type.toString()
+                << "[" << r.guid << "]\",\"cat\":\"" << r.type.toString()
+                << "\",\"ph\":\"X\",\"ts\":" << r.begin
+                << ",\"dur\":" << r.duration
+                << ",\"pid\":0,\"tid\":" << r.thread
+                << ",\"args\":{\"guid\":" << r.guid << ",\"kernel\":\""
+                << r.kernel << "\",\"bytes_read\":" << r.bytesRead
+                << ",\"bytes_written\":" << r.bytesWritten
+                << ",\"flops\":" << r.flops << "}}";
+        }
+        ofs << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+
+} // namespace infini
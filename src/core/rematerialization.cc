@@ -0,0 +1,43 @@
+#include "core/rematerialization.h"
+#include <sstream>
+
+namespace infini
+{
+
+    size_t getRecomputeCost(const Operator &op)
+    {
+        size_t elements = 0;
+        for (auto &output : op->getOutputs())
+            elements += output->size();
+        switch (op->getOpType().underlying())
+        {
+        case OpType::Add:
+        case OpType::Sub:
+        case OpType::Mul:
+        case OpType::Div:
+        case OpType::Relu:
+        case OpType::Clip:
+        case OpType::Cast:
+            return std::max<size_t>(elements, 1);
+        // strided reads cost about twice as much
+        case OpType::Transpose:
+            return std::max<size_t>(elements * 2, 1);
+        default:
+            return 0;
+        }
+    }
+
+    string RematerializationReport::toString() const
+    {
+        std::ostringstream oss;
+        oss << "Rematerialization: budget " << budget << " bytes, peak "
+            << peakBefore << " -> " << peakAfter << " bytes ("
+            << (fits() ? "fits" : "does not fit") << "), " << recomputed
+            << " operators recomputed, extra cost " << extraCost
+            << " element operations\n";
+        for (auto &decision : decisions)
+            oss << "  " << decision << "\n";
+        return oss.str();
+    }
+
+} // namespace infini
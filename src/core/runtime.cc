@@ -2,35 +2,272 @@
 #include "core/blob.h"
 #include "core/kernel.h"
 #include "core/graph.h"
-#include "core/kernel.h"
+#include "core/profiler.h"
+#include "core/tuner.h"
 #include <chrono>
 #include <cstring>
+#include <fcntl.h>
 #include <memory>
+#include <mutex>
+#include <sys/mman.h>
+#include <unistd.h>
 namespace infini
 {
+    KernelTuner &RuntimeObj::getTuner()
+    {
+        if (!tuner)
+            tuner = make_ref<KernelTuner>();
+        return *tuner;
+    }
+
+    void RuntimeObj::tune(const Graph &graph) { getTuner().tune(graph, this); }
+
+    void RuntimeObj::setAlignment(size_t alignment)
+    {
+        IT_ASSERT(alignment >= sizeof(void *) &&
+                      (alignment & (alignment - 1)) == 0,
+                  "Invalid alignment " + std::to_string(alignment));
+        this->alignment = alignment;
+    }
+
+    void RuntimeObj::setThreadCount(int threads)
+    {
+        setThreadPool(make_ref<ThreadPool>(threads));
+    }
+
+    void RuntimeObj::setThreadPool(Ref<ThreadPool> pool)
+    {
+        IT_ASSERT(pool != nullptr);
+        // a pool shared with the application keeps its own pinning
+        if (!threadCpus.empty())
+            pool->setAffinity(threadCpus);
+        std::lock_guard<std::mutex> lock(threadPoolMutex);
+        threadPool = std::move(pool);
+    }
+
+    ThreadPool &RuntimeObj::getThreadPool() const
+    {
+        std::lock_guard<std::mutex> lock(threadPoolMutex);
+        if (!threadPool)
+        {
+            threadPool = make_ref<ThreadPool>(defaultThreads);
+            threadPool->setAffinity(threadCpus);
+        }
+        return *threadPool;
+    }
+
+    void RuntimeObj::setThreadCpus(vector<vector<int>> cpus)
+    {
+        threadCpus = std::move(cpus);
+        std::lock_guard<std::mutex> lock(threadPoolMutex);
+        if (threadPool)
+            threadPool->setAffinity(threadCpus);
+    }
+
+    void RuntimeObj::setProfiling(bool enable)
+    {
+        if (!enable)
+            profiler = nullptr;
+        else if (!profiler)
+            profiler = make_ref<Profiler>();
+    }
+
+    Profiler &RuntimeObj::getProfiler()
+    {
+        IT_ASSERT(profiler != nullptr, "Profiling is not enabled");
+        return *profiler;
+    }
+
+    NativeCpuRuntimeObj::NativeCpuRuntimeObj(int numaNode)
+        : RuntimeObj(Device::CPU), numaNode(numaNode)
+    {
+        if (numaNode >= 0)
+        {
+            // throws for nodes that do not exist
+            auto cpus = NumaTopology::get().getCpus(Affinity::Compact, numaNode);
+            defaultThreads = cpus.size();
+            setThreadCpus({cpus});
+        }
+    }
+
+    Ref<NativeCpuRuntimeObj> NativeCpuRuntimeObj::getInstance(int numaNode)
+    {
+        static std::mutex mutex;
+        static std::map<int, Ref<NativeCpuRuntimeObj>> instances;
+        std::lock_guard<std::mutex> lock(mutex);
+        auto &instance = instances[numaNode];
+        if (!instance)
+            instance = make_ref<NativeCpuRuntimeObj>(numaNode);
+        return instance;
+    }
+
+    void NativeCpuRuntimeObj::setAffinity(Affinity affinity)
+    {
+        this->affinity = affinity;
+        auto &topology = NumaTopology::get();
+        vector<vector<int>> cpus;
+        for (int cpu : topology.getCpus(affinity, numaNode))
+            cpus.push_back({cpu});
+        // None still pins every thread to all CPUs, which clears the masks
+        // an earlier affinity set
+        if (cpus.empty())
+            cpus.emplace_back(topology.getCpus(Affinity::Compact, numaNode));
+        setThreadCpus(cpus);
+        ++affinityEpoch;
+    }
+
+    string NativeCpuRuntimeObj::getTopologyReport() const
+    {
+        static const char *names[] = {"none", "compact", "scatter"};
+        auto &topology = NumaTopology::get();
+        std::ostringstream oss;
+        oss << topology.toString() << "\n";
+        oss << "runtime node: "
+            << (numaNode < 0 ? "any" : std::to_string(numaNode)) << "\n";
+        oss << "affinity: " << names[int(affinity)];
+        if (affinity != Affinity::None)
+            oss << " " << vecToString(topology.getCpus(affinity, numaNode));
+        oss << "\nthreads: " << getThreadCount();
+        return oss.str();
+    }
+
+    void NativeCpuRuntimeObj::pinThreads() const
+    {
+        // the pool pins its workers; the caller pins itself once per runtime
+        // and affinity setting
+        thread_local const NativeCpuRuntimeObj *pinnedRuntime = nullptr;
+        thread_local unsigned pinnedEpoch = 0;
+        unsigned epoch = affinityEpoch;
+        if (threadCpus.empty() ||
+            (pinnedRuntime == this && pinnedEpoch == epoch))
+            return;
+        vector<int> cpus;
+        for (auto &set : threadCpus)
+            cpus.insert(cpus.end(), set.begin(), set.end());
+        pinThread(cpus);
+        pinnedRuntime = this;
+        pinnedEpoch = epoch;
+    }
+
     void NativeCpuRuntimeObj::run(const Graph &graph) const
     {
+        pinThreads();
         const auto &kernelRegistry = KernelRegistry::getInstance();
 
-        for (auto &op : graph->getOperators())
+        auto &ops = graph->getOperators();
+        for (size_t step = 0; step < ops.size(); ++step)
         {
+            auto &op = ops[step];
+            // no-ops unless the arena is spilled to a file
+            graph->adviseBefore(step);
             auto kernelAttrs = KernelAttrs{device, op->getOpType().underlying()};
-            Kernel *kernel = kernelRegistry.getKernel(kernelAttrs);
-            kernel->compute(op, this);
+            auto &record = tuner ? tuner->select(op, device)
+                                 : kernelRegistry.getKernelItem(kernelAttrs);
+            Kernel *kernel = std::get<0>(record);
+            void *workspace = graph->getWorkspace(op);
+            if (!profiler)
+                kernel->compute(op, workspace, this);
+            else
+            {
+                double begin = profiler->now();
+                kernel->compute(op, workspace, this);
+                profiler->record(op, std::get<1>(record), begin,
+                                 profiler->now());
+            }
+            graph->adviseAfter(step);
         }
     }
 
-    string NativeCpuRuntimeObj::toString() const { return "CPU Runtime"; }
+    string NativeCpuRuntimeObj::toString() const
+    {
+        if (numaNode < 0)
+            return "CPU Runtime";
+        return "CPU Runtime (node " + std::to_string(numaNode) + ")";
+    }
+
+    void NativeCpuRuntimeObj::setSpillDirectory(const string &directory,
+                                                size_t threshold)
+    {
+        spillDirectory = directory;
+        spillThreshold = threshold;
+    }
+
+    bool NativeCpuRuntimeObj::isSpilled(const void *ptr) const
+    {
+        std::lock_guard<std::mutex> lock(spillMutex);
+        return spilled.count(const_cast<void *>(ptr)) > 0;
+    }
+
+    void *NativeCpuRuntimeObj::mapSpillFile(size_t bytes) const
+    {
+        IT_ASSERT(!spillDirectory.empty(), "No spill directory is set");
+        string path = spillDirectory + "/infini-spill-XXXXXX";
+        int fd = mkstemp(path.data());
+        IT_ASSERT(fd >= 0, "Can not create a spill file in " + spillDirectory);
+        // the file is removed with its last mapping; it stays sparse until
+        // pages are written back
+        unlink(path.c_str());
+        void *addr = MAP_FAILED;
+        if (ftruncate(fd, bytes) == 0)
+            addr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                        0);
+        close(fd);
+        IT_ASSERT(addr != MAP_FAILED, "Can not map a spill file of " +
+                                          std::to_string(bytes) + " bytes");
+        return addr;
+    }
 
     void NativeCpuRuntimeObj::dealloc(void *ptr)
     {
+        {
+            std::lock_guard<std::mutex> lock(spillMutex);
+            if (auto it = spilled.find(ptr); it != spilled.end())
+            {
+                munmap(ptr, it->second);
+                spilled.erase(it);
+                return;
+            }
+        }
         return free(ptr);
     }
 
     void *NativeCpuRuntimeObj::alloc(size_t size)
     {
-        return calloc((size + sizeof(uint64_t) - 1) / sizeof(uint64_t),
-                      sizeof(uint64_t));
+        // Spilled blocks are whole pages of a file, aligned for any tensor.
+        if (shouldSpill(size))
+        {
+            size_t page = sysconf(_SC_PAGESIZE);
+            IT_ASSERT(getAlignment() <= page,
+                      "Spilled blocks are only aligned to pages");
+            size = (std::max<size_t>(size, 1) + page - 1) / page * page;
+            void *ptr = mapSpillFile(size);
+            std::lock_guard<std::mutex> lock(spillMutex);
+            spilled[ptr] = size;
+            return ptr;
+        }
+        // Memory is not zeroed, every tensor is written before it is read.
+        // Large blocks are aligned to and padded to whole huge pages, so
+        // transparent huge pages can back them.
+        constexpr size_t kHugePage = 2 << 20;
+        size_t alignment = size >= kHugePage
+                               ? std::max(kHugePage, getAlignment())
+                               : getAlignment();
+        // mbind works on whole pages
+        if (numaNode >= 0)
+            alignment = std::max<size_t>(alignment, sysconf(_SC_PAGESIZE));
+        size = (std::max<size_t>(size, 1) + alignment - 1) / alignment *
+               alignment;
+        void *ptr = nullptr;
+        IT_ASSERT(posix_memalign(&ptr, alignment, size) == 0,
+                  "Failed to allocate " + std::to_string(size) + " bytes");
+#ifdef MADV_HUGEPAGE
+        if (alignment >= kHugePage)
+            madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+        // pages are placed on the node when first touched
+        if (numaNode >= 0)
+            bindMemory(ptr, size, numaNode);
+        return ptr;
     }
 
 } // namespace infini
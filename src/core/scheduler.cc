@@ -0,0 +1,196 @@
+#include "core/scheduler.h"
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+namespace infini
+{
+
+    namespace
+    {
+        // bytes of the outputs of an operator, allocated when it runs
+        size_t getOutputBytes(const GraphTopology &topo, int op,
+                              const vector<size_t> &bytes)
+        {
+            size_t ret = 0;
+            for (int t : topo.getOutputs(op))
+                ret += bytes[t];
+            return ret;
+        }
+
+        // calls f for each distinct input of `op` produced by an operator
+        template <typename F>
+        void forEachProducedInput(const GraphTopology &topo, int op, F f)
+        {
+            auto inputs = topo.getInputs(op);
+            for (auto it = inputs.begin(); it != inputs.end(); ++it)
+                if (topo.getSource(*it) >= 0 &&
+                    std::find(inputs.begin(), it, *it) == it)
+                    f(*it, std::count(it, inputs.end(), *it));
+        }
+
+        vector<int> scheduleGreedy(const GraphTopology &topo,
+                                   const vector<size_t> &bytes)
+        {
+            int nOps = topo.getOpCount();
+            vector<int> pending(nOps), remaining(topo.getTensorCount()), ready,
+                order;
+            for (int t = 0; t < topo.getTensorCount(); ++t)
+                remaining[t] = topo.getTargets(t).size();
+            for (int op = 0; op < nOps; ++op)
+                if ((pending[op] = topo.getPredecessors(op).size()) == 0)
+                    ready.emplace_back(op);
+            order.reserve(nOps);
+            while (!ready.empty())
+            {
+                // the ready operator growing the live bytes the least
+                auto best = ready.end();
+                int64_t bestDelta = 0;
+                for (auto it = ready.begin(); it != ready.end(); ++it)
+                {
+                    int64_t delta = getOutputBytes(topo, *it, bytes);
+                    forEachProducedInput(topo, *it,
+                                         [&](int t, int uses)
+                                         {
+                                             if (remaining[t] == uses)
+                                                 delta -= bytes[t];
+                                         });
+                    if (best == ready.end() || delta < bestDelta ||
+                        (delta == bestDelta && *it < *best))
+                    {
+                        best = it;
+                        bestDelta = delta;
+                    }
+                }
+                int op = *best;
+                *best = ready.back();
+                ready.pop_back();
+                order.emplace_back(op);
+                for (int t : topo.getInputs(op))
+                    --remaining[t];
+                for (int succ : topo.getSuccessors(op))
+                    if (--pending[succ] == 0)
+                        ready.emplace_back(succ);
+            }
+            return order;
+        }
+
+        // The lowest peak over all orders, by a dynamic program over the sets
+        // of executed operators: the live bytes after a set do not depend on
+        // the order it ran in, so only the lowest peak reaching each set is
+        // kept. Returns an empty order if there are too many sets.
+        vector<int> scheduleExact(const GraphTopology &topo,
+                                  const vector<size_t> &bytes)
+        {
+            using Mask = uint32_t;
+            int nOps = topo.getOpCount();
+            vector<Mask> predMask(nOps, 0), targetMask(topo.getTensorCount(), 0);
+            vector<size_t> outputBytes(nOps);
+            for (int op = 0; op < nOps; ++op)
+            {
+                for (int pred : topo.getPredecessors(op))
+                    predMask[op] |= Mask(1) << pred;
+                for (int t : topo.getInputs(op))
+                    targetMask[t] |= Mask(1) << op;
+                outputBytes[op] = getOutputBytes(topo, op, bytes);
+            }
+
+            struct State
+            {
+                size_t peak, live;
+                Mask prev;
+                int op;
+            };
+            vector<std::unordered_map<Mask, State>> layers(nOps + 1);
+            layers[0].emplace(0, State{0, 0, 0, -1});
+            size_t states = 1;
+            for (int k = 0; k < nOps; ++k)
+                for (auto &[mask, state] : layers[k])
+                    for (int op = 0; op < nOps; ++op)
+                    {
+                        if ((mask >> op & 1) || (predMask[op] & ~mask))
+                            continue;
+                        Mask next = mask | Mask(1) << op;
+                        size_t live = state.live + outputBytes[op];
+                        size_t peak = std::max(state.peak, live);
+                        forEachProducedInput(
+                            topo, op,
+                            [&](int t, int)
+                            {
+                                if ((targetMask[t] & ~next) == 0)
+                                    live -= bytes[t];
+                            });
+                        auto [it, inserted] = layers[k + 1].try_emplace(
+                            next, State{peak, live, mask, op});
+                        if (inserted && ++states > kExactScheduleStates)
+                            return {};
+                        if (!inserted && peak < it->second.peak)
+                            it->second = State{peak, live, mask, op};
+                    }
+
+            auto it = layers[nOps].find((Mask(1) << nOps) - 1);
+            if (it == layers[nOps].end())
+                return {};
+            vector<int> order(nOps);
+            for (int k = nOps; k > 0; --k)
+            {
+                order[k - 1] = it->second.op;
+                it = layers[k - 1].find(it->second.prev);
+            }
+            return order;
+        }
+
+        vector<int> scheduleByDepth(const GraphTopology &topo)
+        {
+            auto order = topo.topoOrder();
+            vector<int> depth(topo.getOpCount(), 0);
+            for (int op : order)
+                for (int pred : topo.getPredecessors(op))
+                    depth[op] = std::max(depth[op], depth[pred] + 1);
+            std::stable_sort(order.begin(), order.end(),
+                             [&](int a, int b) { return depth[a] < depth[b]; });
+            return order;
+        }
+    } // namespace
+
+    vector<int> scheduleOps(const GraphTopology &topo, ScheduleGoal goal,
+                            const vector<size_t> &bytes)
+    {
+        IT_ASSERT(bytes.size() == (size_t)topo.getTensorCount());
+        switch (goal)
+        {
+        case ScheduleGoal::Default:
+            return topo.topoOrder();
+        case ScheduleGoal::MaxParallelism:
+            return scheduleByDepth(topo);
+        case ScheduleGoal::MinMemory:
+            if (topo.getOpCount() <= kExactScheduleOps)
+                if (auto order = scheduleExact(topo, bytes); !order.empty())
+                    return order;
+            return scheduleGreedy(topo, bytes);
+        }
+        IT_TODO_HALT();
+    }
+
+    size_t getPeakLiveBytes(const GraphTopology &topo, const vector<int> &order,
+                            const vector<size_t> &bytes)
+    {
+        vector<int> remaining(topo.getTensorCount());
+        for (int t = 0; t < topo.getTensorCount(); ++t)
+            remaining[t] = topo.getTargets(t).size();
+        size_t live = 0, peak = 0;
+        for (int op : order)
+        {
+            live += getOutputBytes(topo, op, bytes);
+            peak = std::max(peak, live);
+            forEachProducedInput(topo, op,
+                                 [&](int t, int uses)
+                                 {
+                                     if ((remaining[t] -= uses) == 0)
+                                         live -= bytes[t];
+                                 });
+        }
+        return peak;
+    }
+
+} // namespace infini
@@ -0,0 +1,382 @@
+#include "core/serializer.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace infini
+{
+
+    namespace
+    {
+        constexpr char kMagic[8] = {'I', 'T', 'G', 'R', 'A', 'P', 'H', '\0'};
+        constexpr uint32_t kVersion = 1;
+
+        struct FileHeader
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t nTensors;
+            uint32_t nOps;
+            uint32_t reserved;
+            uint64_t metaSize;   // bytes of metadata right after the header
+            uint64_t dataOffset; // start of the weight section in the file
+            uint64_t dataSize;
+        };
+
+        size_t alignUp(size_t size, size_t alignment)
+        {
+            return (size + alignment - 1) / alignment * alignment;
+        }
+
+        class Writer
+        {
+            vector<char> buf;
+
+        public:
+            template <typename T>
+            void put(T val)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                auto p = reinterpret_cast<const char *>(&val);
+                buf.insert(buf.end(), p, p + sizeof(T));
+            }
+            template <typename Ints>
+            void putInts(const Ints &vals)
+            {
+                put<uint32_t>(vals.size());
+                for (auto v : vals)
+                    put<int32_t>(v);
+            }
+            const vector<char> &data() const { return buf; }
+        };
+
+        class Reader
+        {
+            const char *p, *end;
+
+        public:
+            Reader(const char *begin, const char *end) : p(begin), end(end) {}
+            template <typename T>
+            T get()
+            {
+                IT_ASSERT(p + sizeof(T) <= end, "Truncated model file");
+                T val;
+                std::memcpy(&val, p, sizeof(T));
+                p += sizeof(T);
+                return val;
+            }
+            vector<int> getInts()
+            {
+                auto n = get<uint32_t>();
+                IT_ASSERT(n <= size_t(end - p) / sizeof(int32_t),
+                          "Truncated model file");
+                vector<int> vals(n);
+                for (auto &v : vals)
+                    v = get<int32_t>();
+                return vals;
+            }
+        };
+
+        /**
+         * @brief A read-only mapping of a whole file, unmapped on destruction.
+         */
+        class MappedFile
+        {
+            void *addr = MAP_FAILED;
+            size_t size = 0;
+
+        public:
+            explicit MappedFile(const string &path)
+            {
+                int fd = open(path.c_str(), O_RDONLY);
+                IT_ASSERT(fd >= 0, "Can not open " + path);
+                struct stat st;
+                if (fstat(fd, &st) == 0 && st.st_size > 0)
+                {
+                    size = st.st_size;
+                    addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                }
+                close(fd);
+                IT_ASSERT(addr != MAP_FAILED, "Can not map " + path);
+            }
+            MappedFile(const MappedFile &) = delete;
+            MappedFile &operator=(const MappedFile &) = delete;
+            ~MappedFile() { munmap(addr, size); }
+
+            const char *data() const { return static_cast<const char *>(addr); }
+            size_t getSize() const { return size; }
+        };
+
+        void writeAttrs(Writer &w, const Operator &op)
+        {
+            switch (op->getOpType().underlying())
+            {
+            case OpType::MatMul:
+            {
+                auto matmul = as<MatmulObj>(op);
+                w.put<uint8_t>(matmul->getTransA());
+                w.put<uint8_t>(matmul->getTransB());
+                break;
+            }
+            case OpType::Transpose:
+                w.putInts(as<TransposeObj>(op)->getPermute());
+                break;
+            case OpType::Concat:
+                w.put<int32_t>(as<ConcatObj>(op)->getDim());
+                break;
+            case OpType::Clip:
+            {
+                auto clip = as<ClipObj>(op);
+                w.put<uint8_t>(clip->getMin().has_value());
+                w.put<float>(clip->getMin().value_or(0));
+                w.put<uint8_t>(clip->getMax().has_value());
+                w.put<float>(clip->getMax().value_or(0));
+                break;
+            }
+            case OpType::Cast:
+                w.put<int32_t>(enum_to_underlying(as<CastObj>(op)->getType()));
+                break;
+            case OpType::Add:
+            case OpType::Sub:
+            case OpType::Mul:
+            case OpType::Div:
+            case OpType::Relu:
+                break;
+            default:
+                IT_TODO_HALT_MSG(string("Can not serialize ") +
+                                 op->getOpType().toString());
+            }
+        }
+
+        void readOp(Reader &r, GraphObj *g, const TensorVec &tensors)
+        {
+            auto type = OpType(r.get<OpType::underlying_t>());
+            TensorVec inputs, outputs;
+            for (auto idx : r.getInts())
+                inputs.emplace_back(tensors.at(idx));
+            for (auto idx : r.getInts())
+                outputs.emplace_back(tensors.at(idx));
+            IT_ASSERT(!inputs.empty() && outputs.size() == 1);
+            auto input = inputs[0], output = outputs[0];
+            switch (type.underlying())
+            {
+            case OpType::MatMul:
+            {
+                bool transA = r.get<uint8_t>();
+                bool transB = r.get<uint8_t>();
+                g->addOpWithOutputs<MatmulObj>(input, inputs.at(1), output,
+                                               transA, transB);
+                break;
+            }
+            case OpType::Transpose:
+                g->addOpWithOutputs<TransposeObj>(input, output, r.getInts());
+                break;
+            case OpType::Concat:
+                g->addOpWithOutputs<ConcatObj>(inputs, output,
+                                               r.get<int32_t>());
+                break;
+            case OpType::Clip:
+            {
+                std::optional<float> min, max;
+                if (r.get<uint8_t>())
+                    min = r.get<float>();
+                else
+                    r.get<float>();
+                if (r.get<uint8_t>())
+                    max = r.get<float>();
+                else
+                    r.get<float>();
+                g->addOpWithOutputs<ClipObj>(input, output, min, max);
+                break;
+            }
+            case OpType::Cast:
+                g->addOpWithOutputs<CastObj>(input, output,
+                                             CastType(r.get<int32_t>()));
+                break;
+            case OpType::Add:
+                g->addOpWithOutputs<AddObj>(input, inputs.at(1), output);
+                break;
+            case OpType::Sub:
+                g->addOpWithOutputs<SubObj>(input, inputs.at(1), output);
+                break;
+            case OpType::Mul:
+                g->addOpWithOutputs<MulObj>(input, inputs.at(1), output);
+                break;
+            case OpType::Div:
+                g->addOpWithOutputs<DivObj>(input, inputs.at(1), output);
+                break;
+            case OpType::Relu:
+                g->addOpWithOutputs<ReluObj>(input, output);
+                break;
+            default:
+                IT_TODO_HALT_MSG(string("Can not deserialize ") +
+                                 type.toString());
+            }
+        }
+
+        /**
+         * @brief Encodes tensor metadata and operators in topological order.
+         * Weights to save are appended to `weights` with their offsets in
+         * the weight section, whose size is returned in `dataSize`.
+         */
+        Writer encodeGraph(const Graph &graph, bool withWeights,
+                           vector<pair<Tensor, size_t>> &weights,
+                           size_t &dataSize)
+        {
+            IT_ASSERT(graph->topo_sort() == true);
+            auto &tensors = graph->getTensors();
+            auto &ops = graph->getOperators();
+            std::unordered_map<TensorObj *, uint32_t> index;
+            for (auto &t : tensors)
+                index.emplace(t.get(), index.size());
+
+            Writer meta;
+            dataSize = 0;
+            for (auto &t : tensors)
+            {
+                meta.put<int32_t>(t->getDType().getIndex());
+                meta.put<uint8_t>(enum_to_underlying(t->getTensorType()));
+                meta.putInts(t->getDims());
+                bool withData = withWeights && t->isWeight() && t->hasData();
+                meta.put<uint8_t>(withData);
+                meta.put<uint64_t>(withData ? dataSize : 0);
+                if (withData)
+                {
+                    weights.emplace_back(t, dataSize);
+                    dataSize =
+                        alignUp(dataSize + t->getBytes(), kWeightAlignment);
+                }
+            }
+            for (auto &op : ops)
+            {
+                meta.put<OpType::underlying_t>(op->getOpType().underlying());
+                vector<int> inputs, outputs;
+                for (auto &t : op->getInputs())
+                    inputs.emplace_back(index.at(t.get()));
+                for (auto &t : op->getOutputs())
+                    outputs.emplace_back(index.at(t.get()));
+                meta.putInts(inputs);
+                meta.putInts(outputs);
+                writeAttrs(meta, op);
+            }
+            return meta;
+        }
+    } // namespace
+
+    void saveGraph(const Graph &graph, const string &path, bool withWeights)
+    {
+        // offsets of weight data, relative to the weight section
+        vector<pair<Tensor, size_t>> weights;
+        size_t dataSize;
+        auto meta = encodeGraph(graph, withWeights, weights, dataSize);
+
+        FileHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.nTensors = graph->getTensors().size();
+        header.nOps = graph->getOperators().size();
+        header.metaSize = meta.data().size();
+        header.dataOffset =
+            alignUp(sizeof(FileHeader) + header.metaSize, kWeightAlignment);
+        header.dataSize = dataSize;
+
+        std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+        IT_ASSERT(ofs.is_open(), "Can not open " + path);
+        ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        ofs.write(meta.data().data(), meta.data().size());
+        size_t pos = sizeof(FileHeader) + header.metaSize;
+        const vector<char> zeros(kWeightAlignment, 0);
+        for (auto &[t, offset] : weights)
+        {
+            size_t begin = header.dataOffset + offset;
+            ofs.write(zeros.data(), begin - pos);
+            ofs.write(t->getRawDataPtr<const char *>(), t->getBytes());
+            pos = begin + t->getBytes();
+        }
+        ofs.write(zeros.data(), header.dataOffset + dataSize - pos);
+        IT_ASSERT(ofs.good(), "Failed to write " + path);
+    }
+
+    Graph loadGraph(const string &path, Runtime runtime)
+    {
+        auto file = make_ref<MappedFile>(path);
+        IT_ASSERT(file->getSize() >= sizeof(FileHeader), "Truncated model file");
+        FileHeader header;
+        std::memcpy(&header, file->data(), sizeof(header));
+        IT_ASSERT(std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0,
+                  path + " is not an InfiniTensor model");
+        IT_ASSERT(header.version == kVersion,
+                  "Unsupported model version " + std::to_string(header.version));
+        IT_ASSERT(sizeof(FileHeader) + header.metaSize <= header.dataOffset &&
+                      header.dataOffset + header.dataSize <= file->getSize(),
+                  "Truncated model file");
+
+        Graph g = make_ref<GraphObj>(runtime);
+        Reader r(file->data() + sizeof(FileHeader),
+                 file->data() + sizeof(FileHeader) + header.metaSize);
+        TensorVec tensors;
+        for (uint32_t i = 0; i < header.nTensors; ++i)
+        {
+            auto index = r.get<int32_t>();
+            IT_ASSERT(index > 0 && index < int(std::size(DataType::names)) &&
+                          DataType::sizePerElement[index] > 0,
+                      "Corrupted model file");
+            auto dtype = DataType(index);
+            auto tensorType = r.get<uint8_t>();
+            IT_ASSERT(tensorType <= enum_to_underlying(TensorType::Other),
+                      "Corrupted model file");
+            auto type = TensorType(tensorType);
+            auto dims = r.getInts();
+            bool withData = r.get<uint8_t>();
+            auto offset = r.get<uint64_t>();
+            auto t = g->addTensor(dims, dtype);
+            t->setTensorType(type);
+            if (withData)
+            {
+                IT_ASSERT(offset + t->getBytes() <= header.dataSize,
+                          "Truncated model file");
+                auto ptr = file->data() + header.dataOffset + offset;
+                t->setDataBlob(make_ref<BlobObj>(
+                    runtime, const_cast<char *>(ptr), file));
+            }
+            tensors.emplace_back(t);
+        }
+        for (uint32_t i = 0; i < header.nOps; ++i)
+            readOp(r, g.get(), tensors);
+        return g;
+    }
+
+    uint64_t hashGraph(const Graph &graph)
+    {
+        vector<pair<Tensor, size_t>> weights;
+        size_t dataSize;
+        auto meta = encodeGraph(graph, false, weights, dataSize);
+        // FNV-1a
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (auto c : meta.data())
+            hash = (hash ^ uint8_t(c)) * 0x100000001b3ull;
+        return hash;
+    }
+
+    string encodeAttrs(const Operator &op)
+    {
+        Writer w;
+        writeAttrs(w, op);
+        static const char digits[] = "0123456789abcdef";
+        string ret;
+        for (auto c : w.data())
+        {
+            ret += digits[uint8_t(c) >> 4];
+            ret += digits[uint8_t(c) & 15];
+        }
+        return ret;
+    }
+
+} // namespace infini
@@ -9,7 +9,8 @@ namespace infini {
 
     TensorObj::TensorObj(Shape shape_, DataType dtype, Runtime runtime)
         : dim(shape_.size()), dtype(dtype), runtime(runtime), shape(std::move(shape_)),
-          _size(std::accumulate(shape.begin(), shape.end(), 1, std::multiplies{})) {}
+          _size(std::accumulate(shape.begin(), shape.end(), size_t(1),
+                                std::multiplies{})) {}
 
     string TensorObj::toString() const
     {
@@ -36,9 +37,8 @@ namespace infini {
 
 void TensorObj::setShape(Shape shape_) {
     shape = shape_;
-    size_t size = std::accumulate(shape.begin(), shape.end(), 1,
-                                  [](auto acc, auto x) { return acc * x; });
-    _size = size;
+    _size = std::accumulate(shape.begin(), shape.end(), size_t(1),
+                            std::multiplies{});
 }
 
 void TensorObj::printData() const {
@@ -0,0 +1,145 @@
+#include "core/thread_pool.h"
+#include "core/numa.h"
+
+namespace infini
+{
+
+    namespace
+    {
+        // set on workers and on callers running a job, whose nested loops
+        // run inline
+        thread_local bool inParallelFor = false;
+    } // namespace
+
+    ThreadPool::ThreadPool(int threads, std::chrono::microseconds spin)
+        : threads(threads > 0
+                      ? threads
+                      : std::max(1u, std::thread::hardware_concurrency())),
+          spin(spin)
+    {
+        for (int i = 1; i < this->threads; ++i)
+            workers.emplace_back([this, i] { loop(i); });
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    void ThreadPool::setAffinity(vector<vector<int>> cpus)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->cpus = std::move(cpus);
+        ++affinityEpoch;
+    }
+
+    void ThreadPool::parallel_for(size_t begin, size_t end, size_t grain,
+                                  const Task &task)
+    {
+        if (end <= begin)
+            return;
+        grain = std::max<size_t>(grain, 1);
+        size_t n = end - begin;
+        bool idle = false;
+        if (threads == 1 || n <= grain || inParallelFor ||
+            !busy.compare_exchange_strong(idle, true))
+        {
+            task(begin, end);
+            return;
+        }
+        // about four chunks per thread, so uneven chunks balance out
+        size_t grains = (n + grain - 1) / grain;
+        size_t chunk = grain * std::max<size_t>(1, grains / (threads * 4));
+        Job current{&task, end, chunk};
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = current;
+            next = begin;
+            ++generation;
+        }
+        wake.notify_all();
+
+        inParallelFor = true;
+        work(current);
+        inParallelFor = false;
+
+        std::exception_ptr err;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            // late workers must not join a finished job
+            job.task = nullptr;
+            done.wait(lock, [this] { return active == 0; });
+            std::swap(err, error);
+        }
+        busy = false;
+        if (err)
+            std::rethrow_exception(err);
+    }
+
+    void ThreadPool::work(const Job &job)
+    {
+        while (true)
+        {
+            size_t begin = next.fetch_add(job.chunk);
+            if (begin >= job.end)
+                return;
+            try
+            {
+                (*job.task)(begin, std::min(begin + job.chunk, job.end));
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+    }
+
+    void ThreadPool::loop(int index)
+    {
+        inParallelFor = true;
+        uint64_t seen = 0;
+        unsigned pinned = 0;
+        while (true)
+        {
+            auto deadline = std::chrono::steady_clock::now() + spin;
+            while (generation.load(std::memory_order_acquire) == seen &&
+                   std::chrono::steady_clock::now() < deadline)
+                std::this_thread::yield();
+
+            Job current;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock,
+                          [&] { return stopping || generation != seen; });
+                if (stopping)
+                    return;
+                seen = generation;
+                if (!job.task)
+                    continue;
+                current = job;
+                ++active;
+                if (pinned != affinityEpoch)
+                {
+                    pinned = affinityEpoch;
+                    if (!cpus.empty())
+                        pinThread(cpus[index % cpus.size()]);
+                }
+            }
+            work(current);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--active == 0)
+                    done.notify_all();
+            }
+        }
+    }
+
+} // namespace infini
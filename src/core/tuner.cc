@@ -0,0 +1,144 @@
+#include "core/tuner.h"
+#include "core/graph.h"
+#include "core/serializer.h"
+#include <chrono>
+#include <fstream>
+#include <limits>
+
+namespace infini
+{
+
+    string KernelTuner::getTuningKey(const Operator &op, Device device)
+    {
+        auto kernelAttrs = KernelAttrs{device, op->getOpType().underlying()};
+        std::ostringstream oss;
+        oss << get_kernel_attrs_str(kernelAttrs) << ";"
+            << op->getDType().toString();
+        for (auto &input : op->getInputs())
+            oss << ";" << vecToString(input->getDims());
+        // e.g. transposed and plain MatMuls of the same shapes
+        oss << ";" << encodeAttrs(op);
+        return oss.str();
+    }
+
+    const KernelRegistry::KernelRecord &KernelTuner::select(const Operator &op,
+                                                            Device device) const
+    {
+        {
+            std::shared_lock<std::shared_mutex> lock(resolvedMutex);
+            if (auto it = resolved.find(op->getGuid()); it != resolved.end())
+                return *it->second;
+        }
+        auto &record = lookup(op, device);
+        std::unique_lock<std::shared_mutex> lock(resolvedMutex);
+        resolved[op->getGuid()] = &record;
+        return record;
+    }
+
+    const KernelRegistry::KernelRecord &KernelTuner::lookup(const Operator &op,
+                                                            Device device) const
+    {
+        auto &registry = KernelRegistry::getInstance();
+        auto kernelAttrs = KernelAttrs{device, op->getOpType().underlying()};
+        if (!cache.empty())
+        {
+            auto it = cache.find(getTuningKey(op, device));
+            if (it != cache.end())
+                if (auto record = registry.getKernelItem(kernelAttrs, it->second))
+                    return *record;
+        }
+        return registry.getKernelItem(kernelAttrs);
+    }
+
+    void KernelTuner::tune(const Graph &graph, const RuntimeObj *runtime)
+    {
+        using clock = std::chrono::steady_clock;
+        auto &registry = KernelRegistry::getInstance();
+        auto device = runtime->getDevice();
+        IT_ASSERT(graph->topo_sort() == true);
+        for (auto &op : graph->getOperators())
+        {
+            auto kernelAttrs = KernelAttrs{device, op->getOpType().underlying()};
+            auto &candidates = registry.getKernelItems(kernelAttrs);
+            auto key = getTuningKey(op, device);
+            void *workspace = graph->getWorkspace(op);
+            if (candidates.size() > 1 && cache.find(key) == cache.end())
+            {
+                double best = std::numeric_limits<double>::max();
+                string winner;
+                for (auto &[kernel, name, id] : candidates)
+                {
+                    for (int i = 0; i < warmup; ++i)
+                        kernel->compute(op, workspace, runtime);
+                    double time = std::numeric_limits<double>::max();
+                    for (int i = 0; i < repeat; ++i)
+                    {
+                        auto begin = clock::now();
+                        kernel->compute(op, workspace, runtime);
+                        std::chrono::duration<double> d = clock::now() - begin;
+                        time = std::min(time, d.count());
+                    }
+                    if (time < best)
+                    {
+                        best = time;
+                        winner = name;
+                    }
+                }
+                cache[key] = winner;
+                // operators of this key may have been resolved before
+                std::unique_lock<std::shared_mutex> lock(resolvedMutex);
+                resolved.clear();
+            }
+            // Later operators are measured on the outputs of this one.
+            std::get<0>(select(op, device))->compute(op, workspace, runtime);
+        }
+    }
+
+    void KernelTuner::invalidate(const Operator &op)
+    {
+        std::unique_lock<std::shared_mutex> lock(resolvedMutex);
+        resolved.erase(op->getGuid());
+    }
+
+    void KernelTuner::clear()
+    {
+        cache.clear();
+        std::unique_lock<std::shared_mutex> lock(resolvedMutex);
+        resolved.clear();
+    }
+
+    void KernelTuner::setRepeat(int warmup, int repeat)
+    {
+        IT_ASSERT(warmup >= 0 && repeat > 0);
+        this->warmup = warmup;
+        this->repeat = repeat;
+    }
+
+    void KernelTuner::save(const string &path) const
+    {
+        std::ofstream ofs(path);
+        IT_ASSERT(ofs.is_open(), "Can not open " + path);
+        for (auto &[key, name] : cache)
+            ofs << key << "\t" << name << "\n";
+    }
+
+    bool KernelTuner::load(const string &path)
+    {
+        std::ifstream ifs(path);
+        if (!ifs.is_open())
+            return false;
+        string line;
+        while (std::getline(ifs, line))
+        {
+            auto pos = line.find('\t');
+            if (pos == string::npos)
+                continue;
+            cache[line.substr(0, pos)] = line.substr(pos + 1);
+        }
+        // operators resolved before may have a winner now
+        std::unique_lock<std::shared_mutex> lock(resolvedMutex);
+        resolved.clear();
+        return true;
+    }
+
+} // namespace infini
@@ -0,0 +1,88 @@
+#include "core/weight_arena.h"
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace infini
+{
+
+    WeightArenaObj::WeightArenaObj(Runtime runtime, const TensorVec &weights)
+        : runtime(std::move(runtime))
+    {
+        size_t alignment = this->runtime->getAlignment();
+        for (auto &weight : weights)
+        {
+            entries.emplace_back(bytes, weight->getBytes());
+            bytes += (weight->getBytes() + alignment - 1) / alignment *
+                     alignment;
+        }
+        if (bytes == 0)
+            return;
+
+        // Whole pages, so `seal` can mprotect them; shared, so forked
+        // processes share them. A spill file lets them be paged to disk.
+        size_t page = sysconf(_SC_PAGESIZE);
+        size_t mapped = (bytes + page - 1) / page * page;
+        auto cpu = as<NativeCpuRuntimeObj>(this->runtime);
+        void *addr = cpu && cpu->shouldSpill(mapped)
+                         ? cpu->mapSpillFile(mapped)
+                         : mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        IT_ASSERT(addr != MAP_FAILED, "Can not map a weight arena of " +
+                                          std::to_string(mapped) + " bytes");
+        mapping = Ref<void>(addr, [mapped](void *ptr) { munmap(ptr, mapped); });
+        if (cpu && cpu->getNumaNode() >= 0)
+            bindMemory(addr, mapped, cpu->getNumaNode());
+
+        auto base = static_cast<char *>(addr);
+        for (size_t i = 0; i < weights.size(); ++i)
+            if (weights[i]->hasData())
+                std::memcpy(base + entries[i].first,
+                            weights[i]->getRawDataPtr<void *>(),
+                            entries[i].second);
+        bind(weights);
+    }
+
+    string WeightArenaObj::toString() const
+    {
+        return "WeightArena " + std::to_string(guid) + ": " +
+               std::to_string(entries.size()) + " weights, " +
+               std::to_string(bytes) + " bytes" +
+               (sealed ? ", read-only" : "");
+    }
+
+    bool WeightArenaObj::contains(const void *ptr) const
+    {
+        auto base = static_cast<const char *>(mapping.get());
+        auto p = static_cast<const char *>(ptr);
+        return base && p >= base && p < base + bytes;
+    }
+
+    void WeightArenaObj::seal()
+    {
+        if (sealed || !mapping)
+        {
+            sealed = true;
+            return;
+        }
+        size_t page = sysconf(_SC_PAGESIZE);
+        size_t mapped = (bytes + page - 1) / page * page;
+        IT_ASSERT(mprotect(mapping.get(), mapped, PROT_READ) == 0,
+                  "Can not make the weight arena read-only");
+        sealed = true;
+    }
+
+    void WeightArenaObj::bind(const TensorVec &weights) const
+    {
+        IT_ASSERT(weights.size() == entries.size(),
+                  "Weights do not match the arena");
+        auto base = static_cast<char *>(mapping.get());
+        for (size_t i = 0; i < weights.size(); ++i)
+        {
+            IT_ASSERT(weights[i]->getBytes() == entries[i].second,
+                      "Weights do not match the arena");
+            weights[i]->setDataBlob(make_ref<BlobObj>(
+                runtime, base + entries[i].first, mapping));
+        }
+    }
+
+} // namespace infini
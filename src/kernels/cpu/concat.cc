@@ -1,5 +1,6 @@
 #include "operators/concat.h"
 #include "core/kernel.h"
+#include "utils/operator_utils.h"
 
 namespace infini {
 
@@ -7,23 +8,19 @@ class NaiveConcat : public CpuKernelWithoutConfig {
     template <typename T>
     void doCompute(const Operator &_op, const RuntimeObj *context) const {
         auto op = as<ConcatObj>(_op);
-        auto inputs = op->getInputs(), outputs = op->getOutputs();
+        const auto &inputs = op->getInputs();
         auto dim = op->getDim();
-        auto output = outputs[0];
-        std::vector<Shape> iDims;
-        for (auto input : inputs)
-            iDims.emplace_back(input->getDims());
+        auto output = op->getOutput();
         const auto &outDim = output->getDims();
         size_t blockOffsetInner = 1;
         for (size_t i = outDim.size() - 1; i > (size_t)dim; --i)
             blockOffsetInner *= outDim[i];
         size_t blockOffset = outDim[dim] * blockOffsetInner;
+        // offset of the current input along dim in the output
+        int dimOffset = 0;
         for (size_t i = 0; i < inputs.size(); ++i) {
             auto input = inputs[i];
-            auto dimOffset = 0;
-            auto iDim = iDims[i];
-            for (size_t j = 0; j < i; ++j)
-                dimOffset += iDims[j][dim];
+            const auto &iDim = input->getDims();
             size_t localBlockOffset = 1;
             for (size_t i = iDim.size() - 1;
                  i >= (size_t)dim && i != (size_t)-1; --i)
@@ -32,16 +29,20 @@ class NaiveConcat : public CpuKernelWithoutConfig {
             auto inSize = input->size();
             auto inPtr = input->getRawDataPtr<T *>(),
                  outPtr = output->getRawDataPtr<T *>();
-#pragma omp parallel for
-            for (size_t iOffset = 0; iOffset < inSize; ++iOffset) {
-                auto oOffset = iOffset % localBlockOffset + innerOffset +
-                               iOffset / localBlockOffset * blockOffset;
-                outPtr[oOffset] = inPtr[iOffset];
-            }
+            context->parallel_for(
+                0, inSize, kParallelGrain, [&](size_t begin, size_t end) {
+                    for (size_t iOffset = begin; iOffset < end; ++iOffset) {
+                        auto oOffset = iOffset % localBlockOffset +
+                                       innerOffset +
+                                       iOffset / localBlockOffset * blockOffset;
+                        outPtr[oOffset] = inPtr[iOffset];
+                    }
+                });
+            dimOffset += iDim[dim];
         }
     }
 
-    void compute(const Operator &_op,
+    void compute(const Operator &_op, void *,
                  const RuntimeObj *context) const override {
 #define CASE(N)                                                                \
     case N:                                                                    \
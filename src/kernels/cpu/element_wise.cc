@@ -30,8 +30,9 @@ namespace infini
             return (T)(val0 / val1);
         }
 
-        template <typename T>
-        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        template <typename T, typename F>
+        void doCompute(const Operator &_op, const RuntimeObj *context,
+                       F _doCompute) const
         {
             auto op = as<ElementWiseObj>(_op);
             T *inptr0 = op->getInputs(0)->getRawDataPtr<T *>();
@@ -41,6 +42,17 @@ namespace infini
             auto shapeA = op->getInputs(0)->getDims();
             auto shapeB = op->getInputs(1)->getDims();
             auto shapeC = op->getOutput()->getDims();
+            auto n = op->getOutput()->size();
+            // no broadcast: a flat loop
+            if (shapeA == shapeC && shapeB == shapeC)
+            {
+                context->parallel_for(
+                    0, n, kParallelGrain, [&](size_t begin, size_t end)
+                    { apply_contiguous(inptr0 + begin, inptr1 + begin,
+                                       outptr + begin, end - begin,
+                                       _doCompute); });
+                return;
+            }
             auto rank = op->getOutput()->getRank();
             Shape a(rank, 1);
             Shape b(rank, 1);
@@ -48,51 +60,51 @@ namespace infini
                       a.begin() + (rank - shapeA.size()));
             std::copy(shapeB.begin(), shapeB.end(),
                       b.begin() + (rank - shapeB.size()));
-            auto getStride = [&](const Shape &shape)
-            {
-                int p = 1;
-                Shape stride(rank);
-                for (auto i = rank; i > 0; --i)
+            Stride strideA = get_stride(a);
+            Stride strideB = get_stride(b);
+
+            context->parallel_for(
+                0, n, kParallelGrain, [&](size_t begin, size_t end)
                 {
-                    stride[i - 1] = p;
-                    p = p * shape[i - 1];
-                }
-                return stride;
-            };
-            Shape strideA = getStride(a);
-            Shape strideB = getStride(b);
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        auto shapeIndexC = locate_index(i, shapeC);
+                        auto indexA = delocate_index(shapeIndexC, a, strideA);
+                        auto indexB = delocate_index(shapeIndexC, b, strideB);
+                        outptr[i] = _doCompute(inptr0[indexA], inptr1[indexB]);
+                    }
+                });
+        }
 
-            auto n = op->getOutput()->size();
-            T (*_doCompute)
-            (T val0, T val1);
-            switch (op->getOpType().underlying())
+        template <typename T>
+        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        {
+            // lambdas instead of function pointers, so the loops can inline
+            // and vectorize them
+            switch (_op->getOpType().underlying())
             {
             case OpType::Add:
-                _doCompute = addCompute<T>;
+                doCompute<T>(_op, context,
+                             [](T a, T b) { return addCompute(a, b); });
                 break;
             case OpType::Sub:
-                _doCompute = subCompute<T>;
+                doCompute<T>(_op, context,
+                             [](T a, T b) { return subCompute(a, b); });
                 break;
             case OpType::Mul:
-                _doCompute = mulCompute<T>;
+                doCompute<T>(_op, context,
+                             [](T a, T b) { return mulCompute(a, b); });
                 break;
             case OpType::Div:
-                _doCompute = divCompute<T>;
+                doCompute<T>(_op, context,
+                             [](T a, T b) { return divCompute(a, b); });
                 break;
             default:
                 IT_TODO_HALT();
             }
-
-            for (size_t i = 0; i < n; ++i)
-            {
-                auto shapeIndexC = locate_index(i, shapeC);
-                auto indexA = delocate_index(shapeIndexC, a, strideA);
-                auto indexB = delocate_index(shapeIndexC, b, strideB);
-                outptr[i] = _doCompute(inptr0[indexA], inptr1[indexB]);
-            }
         }
 
-        void compute(const Operator &_op,
+        void compute(const Operator &_op, void *,
                      const RuntimeObj *context) const override
         {
 #define CASE(N) \
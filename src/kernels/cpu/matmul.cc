@@ -0,0 +1,259 @@
+#include "operators/matmul.h"
+#include "core/kernel.h"
+#include "utils/operator_utils.h"
+
+namespace infini
+{
+    /**
+     * @brief Shared batch handling of the MatMul kernels. The leading dims of A
+     * and B are broadcast to the leading dims of C; the kernels only implement
+     * the product of one [m, k] x [k, n] pair. Kernels declaring a workspace
+     * get a transposed B packed into it as [k, n] matrices.
+     */
+    class MatmulKernelBase : public CpuKernelWithoutConfig
+    {
+    protected:
+        struct MatmulArgs
+        {
+            int m, n, k;
+            bool transA, transB;
+            // the rows of C to compute
+            int rowBegin, rowEnd;
+        };
+
+        // rows of C per task on the thread pool
+        static constexpr int taskRows = 16;
+
+        template <typename T>
+        void doCompute(const Operator &_op, void *workspace,
+                       const RuntimeObj *context) const
+        {
+            auto op = as<MatmulObj>(_op);
+            T *ptrA = op->getInputs(0)->getRawDataPtr<T *>();
+            T *ptrB = op->getInputs(1)->getRawDataPtr<T *>();
+            T *ptrC = op->getOutput()->getRawDataPtr<T *>();
+            MatmulArgs args{op->getM(), op->getN(), op->getK(),
+                            op->getTransA(), op->getTransB(), 0, op->getM()};
+            // the workspace is planned for the largest variant, so only
+            // kernels asking for one pack into it
+            if (workspace && args.transB && args.k > 0 &&
+                getWorkspaceSize(_op) > 0)
+            {
+                ptrB = packB(ptrB, op->getInputs(1)->size(), args,
+                             static_cast<T *>(workspace), context);
+                args.transB = false;
+            }
+
+            auto shapeC = op->getOutput()->getDims();
+            auto rank = shapeC.size();
+            Shape batchC(shapeC.begin(), shapeC.end() - 2);
+            auto getBatch = [&](const Shape &shape)
+            {
+                Shape batch(rank - 2, 1);
+                std::copy(shape.begin(), shape.end() - 2,
+                          batch.end() - (shape.size() - 2));
+                return batch;
+            };
+            Shape batchA = getBatch(op->getInputs(0)->getDims());
+            Shape batchB = getBatch(op->getInputs(1)->getDims());
+            Stride strideA = get_stride(batchA), strideB = get_stride(batchB);
+
+            size_t nBatch = op->getOutput()->size() / ((size_t)args.m * args.n);
+            // tasks are blocks of taskRows rows of one batch, grouped so a
+            // chunk has enough multiply-adds to pay for running in parallel
+            size_t rowBlocks = (args.m + taskRows - 1) / taskRows;
+            size_t taskWork = (size_t)taskRows * args.n * args.k + 1;
+            size_t grain = std::max<size_t>(1, kParallelGrain * 4 / taskWork);
+            context->parallel_for(
+                0, nBatch * rowBlocks, grain, [&](size_t begin, size_t end)
+                {
+                    for (size_t task = begin; task < end; ++task)
+                    {
+                        size_t b = task / rowBlocks;
+                        auto index = locate_index(b, batchC);
+                        auto offsetA = delocate_index(index, batchA, strideA);
+                        auto offsetB = delocate_index(index, batchB, strideB);
+                        MatmulArgs rows = args;
+                        rows.rowBegin = task % rowBlocks * taskRows;
+                        rows.rowEnd =
+                            std::min(rows.rowBegin + taskRows, args.m);
+                        gemm(rows, ptrA + offsetA * args.m * args.k,
+                             ptrB + offsetB * args.k * args.n,
+                             ptrC + b * args.m * args.n);
+                    }
+                });
+        }
+
+        // transposes each [n, k] matrix of B into a row of `packed`
+        template <typename T>
+        static T *packB(const T *B, size_t size, const MatmulArgs &args,
+                        T *packed, const RuntimeObj *context)
+        {
+            size_t n = args.n, k = args.k;
+            context->parallel_for(
+                0, size / k, std::max<size_t>(1, kParallelGrain / k),
+                [&](size_t begin, size_t end)
+                {
+                    for (size_t row = begin; row < end; ++row)
+                    {
+                        // row j of matrix b of B is column j of packed b
+                        size_t b = row / n, j = row % n;
+                        const T *src = B + row * k;
+                        T *dst = packed + b * k * n + j;
+                        for (size_t l = 0; l < k; ++l)
+                            dst[l * n] = src[l];
+                    }
+                });
+            return packed;
+        }
+
+        // Index math within one matrix is done in I, int32_t when all of A,
+        // B and C have less than 2^31 elements, see `dispatch_index`.
+        template <typename I, typename T>
+        static T loadA(const MatmulArgs &args, const T *A, I i, I l)
+        {
+            return args.transA ? A[l * I(args.m) + i] : A[i * I(args.k) + l];
+        }
+
+        template <typename I, typename T>
+        static T loadB(const MatmulArgs &args, const T *B, I l, I j)
+        {
+            return args.transB ? B[j * I(args.k) + l] : B[l * I(args.n) + j];
+        }
+
+        static size_t getMaxElems(const MatmulArgs &args)
+        {
+            size_t m = args.m, n = args.n, k = args.k;
+            return std::max({m * k, k * n, m * n});
+        }
+
+        virtual void gemm(const MatmulArgs &args, const float *A, const float *B,
+                          float *C) const = 0;
+        virtual void gemm(const MatmulArgs &args, const uint32_t *A,
+                          const uint32_t *B, uint32_t *C) const = 0;
+
+    public:
+        void compute(const Operator &_op, void *workspace,
+                     const RuntimeObj *context) const override
+        {
+#define CASE(N) \
+    case N:     \
+        doCompute<DT<N>::t>(_op, workspace, context)
+
+            int dataTypeIdx = _op->getDType().getIndex();
+            switch (dataTypeIdx)
+            {
+                CASE(1); // DataType::Float32
+                break;
+                CASE(12); // DataType::UInt32
+                break;
+            default:
+                IT_TODO_HALT();
+            }
+        }
+    };
+
+    /**
+     * @brief Inner-product order, one dot product per element of C.
+     */
+    class NaiveMatmul : public MatmulKernelBase
+    {
+        template <typename I, typename T>
+        static void gemmLoop(const MatmulArgs &args, const T *A, const T *B,
+                             T *C)
+        {
+            for (I i = args.rowBegin; i < args.rowEnd; ++i)
+                for (I j = 0; j < args.n; ++j)
+                {
+                    T sum = 0;
+                    for (I l = 0; l < args.k; ++l)
+                        sum += loadA(args, A, i, l) * loadB(args, B, l, j);
+                    C[i * I(args.n) + j] = sum;
+                }
+        }
+
+        template <typename T>
+        static void gemmImpl(const MatmulArgs &args, const T *A, const T *B,
+                             T *C)
+        {
+            dispatch_index(getMaxElems(args), [&](auto zero)
+                           { gemmLoop<decltype(zero)>(args, A, B, C); });
+        }
+
+        void gemm(const MatmulArgs &args, const float *A, const float *B,
+                  float *C) const override
+        {
+            gemmImpl(args, A, B, C);
+        }
+        void gemm(const MatmulArgs &args, const uint32_t *A, const uint32_t *B,
+                  uint32_t *C) const override
+        {
+            gemmImpl(args, A, B, C);
+        }
+    };
+
+    /**
+     * @brief Cache-blocked i-k-j order. The innermost loop walks a row of C
+     * and a row of B; a transposed B is packed in the workspace first.
+     */
+    class BlockedMatmul : public MatmulKernelBase
+    {
+        static constexpr int tile = 64;
+
+    public:
+        size_t getWorkspaceSize(const Operator &op) const override
+        {
+            auto matmul = as<MatmulObj>(op);
+            return matmul->getTransB() ? matmul->getInputs(1)->getBytes() : 0;
+        }
+
+    private:
+        template <typename I, typename T>
+        static void gemmLoop(const MatmulArgs &args, const T *A, const T *B,
+                             T *C)
+        {
+            std::fill(C + (size_t)args.rowBegin * args.n,
+                      C + (size_t)args.rowEnd * args.n, T(0));
+            for (I i0 = args.rowBegin; i0 < args.rowEnd; i0 += tile)
+                for (I l0 = 0; l0 < args.k; l0 += tile)
+                    for (I j0 = 0; j0 < args.n; j0 += tile)
+                    {
+                        I iEnd = std::min<I>(i0 + tile, args.rowEnd);
+                        I lEnd = std::min<I>(l0 + tile, args.k);
+                        I jEnd = std::min<I>(j0 + tile, args.n);
+                        for (I i = i0; i < iEnd; ++i)
+                            for (I l = l0; l < lEnd; ++l)
+                            {
+                                T a = loadA(args, A, i, l);
+                                T *c = C + i * I(args.n);
+                                for (I j = j0; j < jEnd; ++j)
+                                    c[j] += a * loadB(args, B, l, j);
+                            }
+                    }
+        }
+
+        template <typename T>
+        static void gemmImpl(const MatmulArgs &args, const T *A, const T *B,
+                             T *C)
+        {
+            dispatch_index(getMaxElems(args), [&](auto zero)
+                           { gemmLoop<decltype(zero)>(args, A, B, C); });
+        }
+
+        void gemm(const MatmulArgs &args, const float *A, const float *B,
+                  float *C) const override
+        {
+            gemmImpl(args, A, B, C);
+        }
+        void gemm(const MatmulArgs &args, const uint32_t *A, const uint32_t *B,
+                  uint32_t *C) const override
+        {
+            gemmImpl(args, A, B, C);
+        }
+    };
+
+    // The first registered variant is the default one.
+    REGISTER_KERNEL(Device::CPU, OpType::MatMul, NaiveMatmul, "MatmulNaive_CPU");
+    REGISTER_KERNEL(Device::CPU, OpType::MatMul, BlockedMatmul,
+                    "MatmulBlocked_CPU");
+}; // namespace infini
@@ -1,5 +1,6 @@
 #include "operators/transpose.h"
 #include "core/kernel.h"
+#include "utils/operator_utils.h"
 
 namespace infini {
 
@@ -25,18 +26,87 @@ class NaiveTranspose : public CpuKernelWithoutConfig {
         size_t inSize = inputs[0]->size();
         auto inPtr = inputs[0]->getRawDataPtr<T *>(),
              outPtr = outputs[0]->getRawDataPtr<T *>();
-        // #pragma omp parallel for
-        for (size_t inIdx = 0; inIdx < inSize; ++inIdx) {
-            auto posInput = idx2Pos(inDim, inIdx);
-            int outIdx = 0;
-            for (size_t j = 0, jEnd = perm.size(); j < jEnd; ++j) {
-                outIdx = outIdx * inDim[perm[j]] + posInput[perm[j]];
-            }
-            outPtr[outIdx] = inPtr[inIdx];
+        dispatch_index(inSize, [&](auto zero) {
+            using I = decltype(zero);
+            context->parallel_for(
+                0, inSize, kParallelGrain, [&](size_t begin, size_t end) {
+                    for (size_t inIdx = begin; inIdx < end; ++inIdx) {
+                        auto posInput = idx2Pos(inDim, inIdx);
+                        I outIdx = 0;
+                        for (size_t j = 0, jEnd = perm.size(); j < jEnd; ++j) {
+                            outIdx = outIdx * I(inDim[perm[j]]) +
+                                     posInput[perm[j]];
+                        }
+                        outPtr[outIdx] = inPtr[inIdx];
+                    }
+                });
+        });
+    }
+
+    void compute(const Operator &_op, void *,
+                 const RuntimeObj *context) const override {
+#define CASE(N)                                                                \
+    case N:                                                                    \
+        doCompute<DT<N>::t>(_op, context)
+
+        int dataTypeIdx = _op->getDType().getIndex();
+        switch (dataTypeIdx) {
+            CASE(1); // DataType::Float32
+            break;
+            CASE(12); // DataType::UInt32
+            break;
+        default:
+            IT_TODO_HALT();
         }
     }
+};
+
+/**
+ * @brief Walks the output sequentially and keeps the input offset up to date
+ * with an odometer over the output dims, so no per-element index vector is
+ * built. Writes are contiguous, reads are strided.
+ */
+class StridedTranspose : public CpuKernelWithoutConfig {
+    template <typename T>
+    void doCompute(const Operator &_op, const RuntimeObj *context) const {
+        auto op = as<TransposeObj>(_op);
+        const auto &inDim = op->getInputs(0)->getDims();
+        const auto &outDim = op->getOutput()->getDims();
+        const auto &perm = op->getPermute();
+        auto rank = inDim.size();
+
+        // inStride[i] is the input stride of output dim i
+        Stride inStride(rank), stride = get_stride(inDim);
+        for (size_t i = 0; i < rank; ++i)
+            inStride[i] = stride[perm[i]];
+
+        size_t outSize = op->getOutput()->size();
+        auto inPtr = op->getInputs(0)->getRawDataPtr<T *>(),
+             outPtr = op->getOutput()->getRawDataPtr<T *>();
+        context->parallel_for(
+            0, outSize, kParallelGrain, [&](size_t begin, size_t end) {
+                // start the odometer at the first output of the chunk
+                Shape pos(rank, 0);
+                StrideElem inIdx = 0;
+                for (size_t j = rank, rest = begin; j > 0; --j) {
+                    pos[j - 1] = rest % outDim[j - 1];
+                    rest /= outDim[j - 1];
+                    inIdx += StrideElem(pos[j - 1]) * inStride[j - 1];
+                }
+                for (size_t outIdx = begin; outIdx < end; ++outIdx) {
+                    outPtr[outIdx] = inPtr[inIdx];
+                    for (size_t j = rank; j > 0; --j) {
+                        inIdx += inStride[j - 1];
+                        if (++pos[j - 1] < outDim[j - 1])
+                            break;
+                        inIdx -= inStride[j - 1] * outDim[j - 1];
+                        pos[j - 1] = 0;
+                    }
+                }
+            });
+    }
 
-    void compute(const Operator &_op,
+    void compute(const Operator &_op, void *,
                  const RuntimeObj *context) const override {
 #define CASE(N)                                                                \
     case N:                                                                    \
@@ -54,7 +124,10 @@ class NaiveTranspose : public CpuKernelWithoutConfig {
     }
 };
 
+// The first registered variant is the default one.
 REGISTER_KERNEL(Device::CPU, OpType::Transpose, NaiveTranspose,
                 "TransposeNaive_CPU");
+REGISTER_KERNEL(Device::CPU, OpType::Transpose, StridedTranspose,
+                "TransposeStrided_CPU");
 
 } // namespace infini
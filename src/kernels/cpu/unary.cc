@@ -1,5 +1,6 @@
 #include "operators/unary.h"
 #include "core/kernel.h"
+#include "utils/operator_utils.h"
 
 namespace infini
 {
@@ -18,27 +19,23 @@ namespace infini
             T *inptr = op->getInputs(0)->getRawDataPtr<T *>();
             T *outptr = op->getOutput()->getRawDataPtr<T *>();
 
-            auto outDim = op->getOutput()->getDims();
             auto n = op->getOutput()->size();
 
-            T (*_doCompute)
-            (T val);
             switch (op->getOpType().underlying())
             {
             case OpType::Relu:
-                _doCompute = reluCompute<T>;
+                context->parallel_for(
+                    0, n, kParallelGrain, [&](size_t begin, size_t end)
+                    { apply_contiguous(inptr + begin, outptr + begin,
+                                       end - begin,
+                                       [](T val) { return reluCompute(val); }); });
                 break;
             default:
                 IT_TODO_HALT();
             }
-
-            for (size_t offset = 0; offset < n; offset++)
-            {
-                outptr[offset] = _doCompute(inptr[offset]);
-            }
         }
 
-        void compute(const Operator &_op,
+        void compute(const Operator &_op, void *,
                      const RuntimeObj *context) const override
         {
 #define CASE(N) \
@@ -70,16 +67,19 @@ namespace infini
             auto maxValue = op->getMax();
 
             auto n = op->getOutput()->size();
-            for (size_t offset = 0; offset < n; offset++)
+            auto clip = [minValue, maxValue](T val)
             {
-                auto val = *inptr++;
-                *outptr++ = (minValue && val < *minValue)   ? *minValue
-                            : (maxValue && val > *maxValue) ? *maxValue
-                                                            : val;
-            }
+                return (minValue && val < *minValue)   ? T(*minValue)
+                       : (maxValue && val > *maxValue) ? T(*maxValue)
+                                                       : val;
+            };
+            context->parallel_for(
+                0, n, kParallelGrain, [&](size_t begin, size_t end)
+                { apply_contiguous(inptr + begin, outptr + begin, end - begin,
+                                   clip); });
         }
 
-        void compute(const Operator &_op,
+        void compute(const Operator &_op, void *,
                      const RuntimeObj *context) const override
         {
 #define CASE(N) \
@@ -0,0 +1,103 @@
+#include "utils/graph_generator.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+namespace infini {
+
+Graph makeTransformerGraph(Runtime runtime, int layers, int seqLen, int hidden,
+                           int heads, DataType dtype) {
+    IT_ASSERT(layers > 0 && seqLen > 0 && heads > 0);
+    IT_ASSERT(hidden % heads == 0);
+    int headDim = hidden / heads, ffn = 4 * hidden;
+    Graph g = make_ref<GraphObj>(runtime);
+    auto matmul = [&](Tensor a, Tensor b) {
+        return g->addOp<MatmulObj>(a, b, nullptr)->getOutput();
+    };
+    auto add = [&](Tensor a, Tensor b) {
+        return g->addOp<AddObj>(a, b, nullptr)->getOutput();
+    };
+    auto relu = [&](Tensor a) {
+        return g->addOp<ReluObj>(a, nullptr)->getOutput();
+    };
+    auto weight = [&](const Shape &shape) {
+        auto t = g->addTensor(shape, dtype);
+        t->setWeight();
+        return t;
+    };
+
+    auto x = g->addTensor({seqLen, hidden}, dtype);
+    x->setInput();
+    for (int l = 0; l < layers; ++l) {
+        TensorVec attn;
+        for (int h = 0; h < heads; ++h) {
+            auto q = matmul(x, weight({hidden, headDim}));
+            auto k = matmul(x, weight({hidden, headDim}));
+            auto v = matmul(x, weight({hidden, headDim}));
+            auto kT = g->addOp<TransposeObj>(k, nullptr, vector<int>{1, 0})
+                          ->getOutput();
+            // Relu stands in for softmax, which is not supported.
+            auto scores = relu(matmul(q, kT));
+            attn.emplace_back(matmul(scores, v));
+        }
+        auto concat = g->addOp<ConcatObj>(attn, nullptr, 1)->getOutput();
+        auto proj = matmul(concat, weight({hidden, hidden}));
+        x = add(x, proj);
+
+        auto h = matmul(x, weight({hidden, ffn}));
+        h = relu(add(h, weight({ffn})));
+        h = matmul(h, weight({ffn, hidden}));
+        h = add(h, weight({hidden}));
+        x = add(x, h);
+    }
+    return g;
+}
+
+Graph makeChainGraph(Runtime runtime, int depth, const Shape &shape,
+                     DataType dtype) {
+    IT_ASSERT(depth > 0);
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor(shape, dtype);
+    x->setInput();
+    auto residual = x;
+    for (int i = 0; i < depth; ++i) {
+        if (i % 2 == 0) {
+            residual = x;
+            x = g->addOp<ReluObj>(x, nullptr)->getOutput();
+        } else {
+            x = g->addOp<AddObj>(x, residual, nullptr)->getOutput();
+        }
+    }
+    return g;
+}
+
+Graph makeFanOutGraph(Runtime runtime, int width, int depth, const Shape &shape,
+                      DataType dtype) {
+    IT_ASSERT(width > 0 && depth > 0);
+    Graph g = make_ref<GraphObj>(runtime);
+    auto x = g->addTensor(shape, dtype);
+    x->setInput();
+    TensorVec branches;
+    for (int w = 0; w < width; ++w) {
+        Tensor y = x, weight;
+        for (int d = 0; d < depth; ++d) {
+            if (d % 2 == 0) {
+                y = g->addOp<ReluObj>(y, nullptr)->getOutput();
+                continue;
+            }
+            if (!weight) {
+                weight = g->addTensor(shape, dtype);
+                weight->setWeight();
+            }
+            y = g->addOp<MulObj>(y, weight, nullptr)->getOutput();
+        }
+        branches.emplace_back(y);
+    }
+    auto rank = static_cast<int>(shape.size());
+    g->addOp<ConcatObj>(branches, nullptr, rank - 1);
+    return g;
+}
+
+} // namespace infini
@@ -57,26 +57,33 @@ Shape locate_index(size_t inputN, const Shape &shape) {
     auto i = ans.rbegin();
     auto j = shape.rbegin(), ej = shape.rend();
     while (j != ej) {
-        auto div = std::div(inputN, *j++);
-        *i++ = div.rem;
-        inputN = div.quot;
+        size_t dim = *j++;
+        *i++ = inputN % dim;
+        inputN /= dim;
     }
     return ans;
 }
 
 size_t delocate_index(const Shape &shapeIndex, const Shape &shape,
-                      const Shape &stride) {
+                      const Stride &stride) {
     size_t ans = 0;
-    Shape index(shapeIndex.size());
     IT_ASSERT(shapeIndex.size() == shape.size());
     IT_ASSERT(shape.size() == stride.size());
-    for (size_t i = 0; i < shape.size(); ++i) {
-        index[i] = shapeIndex[i] % shape[i];
-        ans += index[i] * stride[i];
-    }
+    for (size_t i = 0; i < shape.size(); ++i)
+        ans += StrideElem(shapeIndex[i] % shape[i]) * stride[i];
     return ans;
 }
 
+Stride get_stride(const Shape &shape) {
+    Stride stride(shape.size());
+    StrideElem p = 1;
+    for (size_t i = shape.size(); i > 0; --i) {
+        stride[i - 1] = p;
+        p *= shape[i - 1];
+    }
+    return stride;
+}
+
 std::string device_to_str(Device device) {
     std::string deviceStr;
     switch (device) {
@@ -93,4 +100,11 @@ std::string get_kernel_attrs_str(const KernelAttrs &kernelAttrs) {
     return deviceStr + ", " + opStr;
 }
 
+bool is_aligned(std::initializer_list<const void *> ptrs, size_t alignment) {
+    for (auto ptr : ptrs)
+        if (reinterpret_cast<uintptr_t>(ptr) % alignment != 0)
+            return false;
+    return true;
+}
+
 } // namespace infini
\ No newline at end of file
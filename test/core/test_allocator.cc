@@ -71,4 +71,60 @@ namespace infini
         EXPECT_EQ(ptr1, ptr2);
     }
 
+    TEST(Allocator, testReuse)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Allocator allocator = Allocator(runtime);
+        size_t offset = allocator.alloc(1000);
+        allocator.alloc(24);
+        allocator.free(offset, 1000);
+        void *ptr = allocator.getPtr();
+        EXPECT_EQ((uintptr_t)ptr % 64, 0u);
+        EXPECT_EQ(allocator.getAllocCount(), 1u);
+        // re-planning within the capacity keeps the memory
+        allocator.reset();
+        EXPECT_EQ(allocator.alloc(512), 0u);
+        EXPECT_EQ(allocator.getPtr(), ptr);
+        EXPECT_EQ(allocator.getAllocCount(), 1u);
+        // and it only grows
+        allocator.reset();
+        allocator.alloc(4096);
+        allocator.getPtr();
+        EXPECT_EQ(allocator.getCapacity(), 4096u);
+        EXPECT_EQ(allocator.getAllocCount(), 2u);
+        allocator.release();
+        EXPECT_EQ(allocator.getCapacity(), 0u);
+    }
+
+    TEST(Allocator, testAlignment)
+    {
+        Runtime runtime = make_ref<NativeCpuRuntimeObj>();
+        EXPECT_EQ(runtime->getAlignment(), 64u);
+        EXPECT_THROW(runtime->setAlignment(48), Exception);
+        runtime->setAlignment(128);
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({3, 5}, DataType::Float32);
+        auto y = g->addOp<ReluObj>(x, nullptr)->getOutput();
+        auto z = g->addOp<ReluObj>(y, nullptr)->getOutput();
+        g->dataMalloc();
+        for (auto &t : {x, y, z})
+            EXPECT_EQ((uintptr_t)t->getRawDataPtr<void *>() % 128, 0u);
+    }
+
+    TEST(Allocator, testWarmDataMalloc)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({64, 64}, DataType::Float32);
+        auto y = g->addOp<ReluObj>(x, nullptr)->getOutput();
+        g->addOp<ReluObj>(y, nullptr);
+        g->dataMalloc();
+        auto ptr = x->getRawDataPtr<void *>();
+        for (int i = 0; i < 3; ++i)
+        {
+            g->dataMalloc();
+            EXPECT_EQ(x->getRawDataPtr<void *>(), ptr);
+        }
+    }
+
 } // namespace infini
@@ -0,0 +1,87 @@
+#include "core/batcher.h"
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    namespace
+    {
+        // Relu(MatMul(x, w)) with x of [rows, 8] and w of ones
+        Graph makeGraph(Runtime runtime)
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({1, 8}, DataType::Float32);
+            auto w = g->addTensor({8, 4}, DataType::Float32);
+            x->setInput();
+            w->setWeight();
+            // weights live outside the arena, which batching re-plans
+            Ref<void> data(runtime->alloc(w->getBytes()),
+                           [runtime](void *ptr) { runtime->dealloc(ptr); });
+            w->setDataBlob(make_ref<BlobObj>(runtime, data.get(), data));
+            w->setData(OneGenerator());
+            auto y = g->addOp<MatmulObj>(x, w, nullptr)->getOutput();
+            g->addOp<ReluObj>(y, nullptr);
+            return g;
+        }
+
+        // `rows` rows filled with `value`
+        vector<char> makeRequest(int rows, float value)
+        {
+            vector<float> input(rows * 8, value);
+            auto bytes = reinterpret_cast<const char *>(input.data());
+            return vector<char>(bytes, bytes + input.size() * sizeof(float));
+        }
+    } // namespace
+
+    TEST(Batcher, CoalesceRequests)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto g = makeGraph(runtime);
+
+        Batcher batcher(g, 8, std::chrono::milliseconds(100));
+        vector<std::future<Batcher::Result>> futures;
+        constexpr int kRequests = 16;
+        // request r has 1 or 2 rows filled with r
+        for (int r = 0; r < kRequests; ++r)
+            futures.emplace_back(batcher.submit(makeRequest(1 + r % 2, r)));
+        for (int r = 0; r < kRequests; ++r)
+        {
+            auto result = futures[r].get();
+            ASSERT_EQ(result.size(), 1u);
+            int rows = 1 + r % 2;
+            ASSERT_EQ(result[0].size(), rows * 4 * sizeof(float));
+            auto out = reinterpret_cast<const float *>(result[0].data());
+            for (int i = 0; i < rows * 4; ++i)
+                EXPECT_EQ(out[i], 8 * r);
+        }
+        EXPECT_EQ(batcher.getRequestCount(), size_t(kRequests));
+        EXPECT_LT(batcher.getBatchCount(), size_t(kRequests));
+        EXPECT_THROW(batcher.submit(vector<char>(5)), Exception);
+    }
+
+    TEST(Batcher, QuietAcrossBatches)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto g = makeGraph(runtime);
+        Batcher batcher(g, 8, std::chrono::milliseconds(1));
+        // one request per batch, so every batch reshapes the graph
+        constexpr int kBatches = 6;
+        testing::internal::CaptureStdout();
+        for (int r = 0; r < kBatches; ++r)
+        {
+            int rows = 1 + r % 3;
+            auto result = batcher.submit(makeRequest(rows, r)).get();
+            ASSERT_EQ(result.size(), 1u);
+            ASSERT_EQ(result[0].size(), rows * 4 * sizeof(float));
+            auto out = reinterpret_cast<const float *>(result[0].data());
+            for (int i = 0; i < rows * 4; ++i)
+                EXPECT_EQ(out[i], 8 * r);
+        }
+        EXPECT_EQ(testing::internal::GetCapturedStdout(), "");
+        EXPECT_EQ(batcher.getBatchCount(), size_t(kBatches));
+    }
+} // namespace infini
@@ -0,0 +1,86 @@
+#include "core/execution_context.h"
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+#include <thread>
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(ExecutionContext, ConcurrentRuns)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({8, 16}, DataType::Float32);
+        auto w = g->addTensor({16, 4}, DataType::Float32);
+        x->setInput();
+        w->setWeight();
+        auto y = g->addOp<MatmulObj>(x, w, nullptr)->getOutput();
+        auto z = g->addOp<ReluObj>(y, nullptr)->getOutput();
+        g->dataMalloc();
+        w->setData(OneGenerator());
+
+        constexpr int kThreads = 4, kRuns = 20;
+        vector<int> failures(kThreads, 0);
+        vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t)
+            threads.emplace_back(
+                [&, t]
+                {
+                    ExecutionContext context(g);
+                    EXPECT_NE(context.getRawDataPtr<void *>(x),
+                              x->getRawDataPtr<void *>());
+                    EXPECT_EQ(context.getRawDataPtr<void *>(w),
+                              w->getRawDataPtr<void *>());
+                    for (int r = 0; r < kRuns; ++r)
+                    {
+                        float val = t * kRuns + r;
+                        {
+                            ExecutionContext::Scope scope(context);
+                            x->setData([val](void *ptr, size_t size, DataType)
+                                       { std::fill_n((float *)ptr, size, val); });
+                        }
+                        context.run();
+                        auto out = context.getRawDataPtr<float *>(z);
+                        for (size_t i = 0; i < z->size(); ++i)
+                            failures[t] += out[i] != 16 * val;
+                    }
+                });
+        for (auto &thread : threads)
+            thread.join();
+        for (int t = 0; t < kThreads; ++t)
+            EXPECT_EQ(failures[t], 0);
+    }
+
+    TEST(ExecutionContext, ExternalData)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({2, 8}, DataType::Float32);
+        auto y = g->addOp<ReluObj>(x, nullptr)->getOutput();
+        vector<float> graphIn(x->size()), graphOut(y->size());
+        g->bindExternalData(x, graphIn.data());
+        g->bindExternalData(y, graphOut.data());
+        g->dataMalloc();
+
+        ExecutionContext context(g);
+        vector<float> in(x->size(), 3.f), out(y->size());
+        EXPECT_THROW(context.bindExternalData(x, (char *)in.data() + 1), Exception);
+        context.bindExternalData(x, in.data());
+        context.bindExternalData(y, out.data());
+        context.run();
+        EXPECT_EQ(out, vector<float>(y->size(), 3.f));
+        EXPECT_EQ(graphOut, vector<float>(y->size(), 0.f));
+    }
+
+    TEST(ExecutionContext, RequiresPlan)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({2, 2}, DataType::Float32);
+        g->addOp<ReluObj>(x, nullptr);
+        EXPECT_THROW(ExecutionContext context(g), Exception);
+    }
+} // namespace infini
@@ -1,8 +1,11 @@
 #include "core/graph.h"
 #include "core/kernel.h"
 #include "core/runtime.h"
+#include "operators/element_wise.h"
 #include "operators/matmul.h"
 #include "operators/transpose.h"
+#include "operators/unary.h"
+#include <numeric>
 
 #include "test.h"
 
@@ -37,4 +40,176 @@ namespace infini
         EXPECT_EQ(op->getTransA(), false);
         EXPECT_EQ(op->getTransB(), true);
     }
-}
\ No newline at end of file
+
+    TEST(Graph, Reshape)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({2, 4}, DataType::Float32);
+        auto w = g->addTensor({4, 3}, DataType::Float32);
+        auto e = g->addTensor({2, 2}, DataType::Float32);
+        auto y = g->addOp<MatmulObj>(x, w, nullptr)->getOutput();
+        auto z = g->addOp<ReluObj>(y, nullptr)->getOutput();
+        auto r = g->addOp<ReluObj>(e, nullptr)->getOutput();
+        g->dataMalloc();
+
+        auto check = [&](int batch)
+        {
+            x->setData(IncrementalGenerator());
+            w->setData(OneGenerator());
+            e->setData(OneGenerator());
+            runtime->run(g);
+            ASSERT_EQ(z->getDims(), (Shape{batch, 3}));
+            auto ptr = z->getRawDataPtr<float *>();
+            for (int i = 0; i < batch; ++i)
+                for (int j = 0; j < 3; ++j)
+                    EXPECT_EQ(ptr[i * 3 + j], 16 * i + 6);
+        };
+        // 61 and 63 rows fall into the same buckets
+        g->reshape({{x, {61, 4}}});
+        EXPECT_EQ(r->getDims(), (Shape{2, 2}));
+        EXPECT_EQ(g->getPlanCacheSize(), 1u);
+        check(61);
+        g->reshape({{x, {63, 4}}});
+        EXPECT_EQ(g->getPlanCacheSize(), 1u);
+        check(63);
+        g->reshape({{x, {200, 4}}});
+        EXPECT_EQ(g->getPlanCacheSize(), 2u);
+        check(200);
+        g->reshape({{x, {61, 4}}});
+        EXPECT_EQ(g->getPlanCacheSize(), 2u);
+        check(61);
+        EXPECT_THROW(g->reshape({{x, {61, 5}}}), Exception);
+
+        // a new order invalidates the lifetimes of the cached plans
+        EXPECT_TRUE(g->schedule(ScheduleGoal::MaxParallelism));
+        EXPECT_EQ(g->getPlanCacheSize(), 0u);
+        g->reshape({{x, {200, 4}}});
+        EXPECT_EQ(g->getPlanCacheSize(), 1u);
+        check(200);
+        EXPECT_EQ(r->getRawDataPtr<float *>()[3], 1);
+
+        // so does excluding a tensor from the arena
+        vector<float> out(200 * 3);
+        g->bindExternalData(z, out.data());
+        EXPECT_EQ(g->getPlanCacheSize(), 0u);
+    }
+
+    TEST(Graph, ExternalData)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({4, 8}, DataType::Float32);
+        auto w = g->addTensor({8, 2}, DataType::Float32);
+        auto y = g->addOp<MatmulObj>(x, w, nullptr)->getOutput();
+        auto z = g->addOp<ReluObj>(y, nullptr)->getOutput();
+        EXPECT_THROW(g->bindExternalData(y, nullptr), Exception);
+
+        vector<float> in(x->size()), out(z->size());
+        std::iota(in.begin(), in.end(), 0.f);
+        g->bindExternalData(x, in.data());
+        g->bindExternalData(z, out.data());
+        EXPECT_THROW(g->bindExternalData(x, (char *)in.data() + 1), Exception);
+        EXPECT_THROW(g->bindExternalData(y, out.data()), Exception);
+        g->dataMalloc();
+        for (auto &p : g->getMemoryPlan().getPlacements())
+        {
+            EXPECT_NE(p.fuid, x->getFuid());
+            EXPECT_NE(p.fuid, z->getFuid());
+        }
+        EXPECT_EQ(x->getRawDataPtr<float *>(), in.data());
+        EXPECT_EQ(z->getRawDataPtr<float *>(), out.data());
+
+        w->setData(OneGenerator());
+        runtime->run(g);
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 2; ++j)
+                EXPECT_EQ(out[i * 2 + j], 64 * i + 28);
+
+        // rebinding swaps the buffers without planning again
+        vector<float> in2(x->size(), -1.f), out2(z->size(), 1.f);
+        g->bindExternalData(x, in2.data());
+        g->bindExternalData(z, out2.data());
+        runtime->run(g);
+        EXPECT_EQ(out2, vector<float>(z->size(), 0.f));
+        EXPECT_EQ(out[0], 28);
+    }
+
+    TEST(Graph, IndexedStorage)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        // a long chain, so quadratic lookups or validation would show
+        constexpr int kOps = 20000;
+        auto x = g->addTensor({4, 4}, DataType::Float32);
+        auto t = x;
+        for (int i = 0; i < kOps; ++i)
+            t = g->addOp<ReluObj>(t, nullptr)->getOutput();
+        EXPECT_TRUE(g->checkValid());
+        for (auto &tensor : g->getTensors())
+            ASSERT_EQ(g->getTensor(tensor->getFuid()), tensor);
+        for (auto &op : g->getOperators())
+            ASSERT_EQ(g->getOperator(op->getGuid()), op);
+
+        // remove every other operator
+        auto ops = g->getOperators();
+        for (int i = 0; i < kOps; i += 2)
+            g->removeOperator(ops[i]);
+        g->removeOperator(ops[0]);
+        EXPECT_EQ(g->getOperator(ops[0]->getGuid()), nullptr);
+        EXPECT_EQ(g->getOperator(ops[1]->getGuid()), ops[1]);
+        auto &kept = g->getOperators();
+        ASSERT_EQ(kept.size(), size_t(kOps / 2));
+        for (int i = 0; i < kOps / 2; ++i)
+            ASSERT_EQ(kept[i], ops[2 * i + 1]);
+        EXPECT_EQ(g->getOperator(ops[3]->getGuid()), ops[3]);
+
+        g->removeTensor(x);
+        EXPECT_EQ(g->getTensor(x->getFuid()), nullptr);
+        EXPECT_EQ(g->getTensors().size(), size_t(kOps));
+        EXPECT_EQ(g->getTensors()[0], ops[0]->getOutput());
+    }
+
+    TEST(Graph, Topology)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({2, 3}, DataType::Float32);
+        auto a = g->addOp<ReluObj>(x, nullptr);
+        auto b = g->addOp<ReluObj>(a->getOutput(), nullptr);
+        auto c = g->addOp<ReluObj>(x, nullptr);
+        auto d = g->addOp<AddObj>(b->getOutput(), c->getOutput(), nullptr);
+        ASSERT_TRUE(g->topo_sort());
+
+        auto &topo = g->getTopology();
+        ASSERT_EQ(topo.getOpCount(), 4);
+        ASSERT_EQ(topo.getTensorCount(), 5);
+        auto ids = [](GraphTopology::Range range)
+        { return vector<int>(range.begin(), range.end()); };
+        int dStep = g->getOperators().size() - 1;
+        EXPECT_EQ(g->getOperators()[dStep], d);
+        EXPECT_EQ(topo.getPredecessors(dStep).size(), 2u);
+        EXPECT_EQ(ids(topo.getTargets(0)).size(), 2u);
+        EXPECT_EQ(topo.getSource(0), -1);
+        EXPECT_EQ(topo.getSource(topo.getTensorId(d->getOutput().get())),
+                  dStep);
+        auto lastUses = topo.lastUses();
+        EXPECT_EQ(lastUses[topo.getTensorId(b->getOutput().get())], dStep);
+        EXPECT_EQ(lastUses[topo.getTensorId(d->getOutput().get())], -1);
+        EXPECT_EQ(g->getInputs(), TensorVec{x});
+        EXPECT_EQ(g->getOutputs(), TensorVec{d->getOutput()});
+
+        // so do added tensors, which are inputs and outputs until connected
+        auto y = g->addTensor({2, 3}, DataType::Float32);
+        auto z = g->addTensor({2, 3}, DataType::Float32);
+        EXPECT_EQ(g->getInputs(), (TensorVec{x, y, z}));
+        EXPECT_EQ(g->getOutputs(), (TensorVec{d->getOutput(), y, z}));
+        g->removeTensor(y);
+        g->removeTensor(z);
+
+        // removals invalidate the snapshot
+        g->removeOperator(d);
+        EXPECT_EQ(g->getTopology().getOpCount(), 3);
+        EXPECT_EQ(g->getOutputs().size(), 3u);
+    }
+}
@@ -0,0 +1,184 @@
+#include "core/graph.h"
+#include "core/graph_cache.h"
+#include "core/runtime.h"
+#include "core/tuner.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+#include <filesystem>
+#include <thread>
+
+#include "test.h"
+
+namespace infini
+{
+    namespace
+    {
+        // Relu(MatMul(Transpose(Transpose(x)), w)), with w bound to `value`.
+        Graph makeGraph(Runtime runtime, float value, int n = 5)
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({2, 3, 4}, DataType::Float32);
+            auto w = g->addTensor({4, n}, DataType::Float32);
+            x->setInput();
+            w->setWeight();
+            Ref<void> data(runtime->alloc(w->getBytes()),
+                           [runtime](void *ptr) { runtime->dealloc(ptr); });
+            w->setDataBlob(make_ref<BlobObj>(runtime, data.get(), data));
+            w->setData([value](void *ptr, size_t size, DataType)
+                       { std::fill_n(static_cast<float *>(ptr), size, value); });
+            auto t = g->addOp<TransposeObj>(x, nullptr, vector<int>{0, 2, 1});
+            t = g->addOp<TransposeObj>(t->getOutput(), nullptr,
+                                       vector<int>{0, 2, 1});
+            auto y = g->addOp<MatmulObj>(t->getOutput(), w, nullptr);
+            g->addOp<ReluObj>(y->getOutput(), nullptr);
+            return g;
+        }
+
+        vector<float> run(Runtime runtime, const Graph &g)
+        {
+            for (auto &t : g->getInputs())
+                if (t->isInput())
+                    t->setData(IncrementalGenerator());
+            runtime->run(g);
+            auto out = g->getOutputs()[0];
+            auto ptr = out->getRawDataPtr<float *>();
+            return vector<float>(ptr, ptr + out->size());
+        }
+    } // namespace
+
+    TEST(GraphCache, HitSkipsPasses)
+    {
+        Runtime runtime = make_ref<NativeCpuRuntimeObj>();
+        auto dir = ::testing::TempDir() + "graph_cache_test";
+        std::filesystem::remove_all(dir);
+
+        auto g1 = makeGraph(runtime, 1);
+        auto key = GraphCache::getKey(g1);
+        EXPECT_EQ(GraphCache::getKey(makeGraph(runtime, 2)), key);
+        EXPECT_NE(GraphCache::getKey(makeGraph(runtime, 1, 6)), key);
+
+        GraphCache cache(dir);
+        EXPECT_FALSE(cache.contains(key));
+        auto compiled = cache.compile(g1, true);
+        EXPECT_EQ(compiled, g1);
+        EXPECT_EQ(cache.getMisses(), 1);
+        EXPECT_TRUE(cache.contains(key));
+        EXPECT_EQ(compiled->getOperators().size(), 2u);
+        auto expected = run(runtime, compiled);
+
+        // A new process: same structure, other weights.
+        runtime->getTuner().clear();
+        GraphCache restarted(dir);
+        auto g2 = makeGraph(runtime, 2);
+        auto loaded = restarted.compile(g2);
+        EXPECT_EQ(restarted.getHits(), 1);
+        EXPECT_NE(loaded, g2);
+        ASSERT_EQ(loaded->getOperators().size(), 2u);
+        EXPECT_EQ(loaded->getOperators()[0]->getOpType(), OpType::MatMul);
+        EXPECT_EQ(loaded->getMemoryPlan().getPeak(),
+                  compiled->getMemoryPlan().getPeak());
+        EXPECT_EQ(runtime->getTuner().size(), 1u);
+        auto result = run(runtime, loaded);
+        ASSERT_EQ(result.size(), expected.size());
+        for (size_t i = 0; i < result.size(); ++i)
+            EXPECT_EQ(result[i], 2 * expected[i]);
+    }
+
+    TEST(GraphCache, BrokenEntryIsRecompiled)
+    {
+        Runtime runtime = make_ref<NativeCpuRuntimeObj>();
+        auto dir = ::testing::TempDir() + "graph_cache_broken";
+        std::filesystem::remove_all(dir);
+        GraphCache cache(dir);
+        auto g = makeGraph(runtime, 1);
+        auto key = GraphCache::getKey(g);
+        cache.compile(g);
+        for (auto &entry : std::filesystem::directory_iterator(dir))
+            if (entry.path().extension() == ".itg")
+                std::ofstream(entry.path(), std::ios::trunc) << "broken";
+
+        auto again = makeGraph(runtime, 1);
+        EXPECT_EQ(cache.compile(again), again);
+        EXPECT_EQ(cache.getHits(), 0);
+        EXPECT_EQ(cache.getMisses(), 2);
+        EXPECT_NE(cache.compile(makeGraph(runtime, 1)), nullptr);
+        EXPECT_EQ(cache.getHits(), 1);
+        EXPECT_TRUE(cache.contains(key));
+    }
+
+    TEST(GraphCache, ConcurrentStores)
+    {
+        Runtime runtime = make_ref<NativeCpuRuntimeObj>();
+        auto dir = ::testing::TempDir() + "graph_cache_concurrent";
+        std::filesystem::remove_all(dir);
+        // every writer misses and stores the same entry
+        constexpr int kWriters = 4;
+        vector<std::thread> writers;
+        for (int i = 0; i < kWriters; ++i)
+            writers.emplace_back(
+                [&]
+                {
+                    GraphCache cache(dir);
+                    for (int j = 0; j < 5; ++j)
+                    {
+                        auto g = makeGraph(runtime, 1);
+                        cache.compile(g);
+                    }
+                });
+        for (auto &writer : writers)
+            writer.join();
+
+        for (auto &entry : std::filesystem::directory_iterator(dir))
+            EXPECT_EQ(entry.path().string().find(".tmp"), string::npos);
+        GraphCache cache(dir);
+        auto g = makeGraph(runtime, 1);
+        auto loaded = cache.compile(g);
+        EXPECT_EQ(cache.getHits(), 1);
+        EXPECT_EQ(run(runtime, loaded).size(), 2u * 3 * 5);
+    }
+
+    TEST(GraphCache, WeightsBoundLater)
+    {
+        Runtime runtime = make_ref<NativeCpuRuntimeObj>();
+        auto dir = ::testing::TempDir() + "graph_cache_unbound";
+        std::filesystem::remove_all(dir);
+        // weights get data only after compiling, as graphs built in code do
+        auto build = [&]
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({2, 4}, DataType::Float32);
+            auto w = g->addTensor({4, 3}, DataType::Float32);
+            x->setInput();
+            w->setWeight();
+            auto y = g->addOp<MatmulObj>(x, w, nullptr);
+            g->addOp<ReluObj>(y->getOutput(), nullptr);
+            return g;
+        };
+        auto setWeights = [](const Graph &g, float value)
+        {
+            for (auto &t : g->getInputs())
+                if (t->isWeight())
+                    t->setData([value](void *ptr, size_t size, DataType)
+                               { std::fill_n(static_cast<float *>(ptr), size,
+                                             value); });
+        };
+
+        auto g1 = build();
+        auto compiled = GraphCache(dir).compile(g1);
+        setWeights(g1, 1);
+        auto expected = run(runtime, compiled);
+
+        GraphCache restarted(dir);
+        auto g2 = build();
+        auto loaded = restarted.compile(g2);
+        EXPECT_EQ(restarted.getHits(), 1);
+        EXPECT_NE(loaded, g2);
+        ASSERT_TRUE(loaded->getWeightArena());
+        setWeights(g2, 2);
+        auto result = run(runtime, loaded);
+        ASSERT_EQ(result.size(), expected.size());
+        for (size_t i = 0; i < result.size(); ++i)
+            EXPECT_EQ(result[i], 2 * expected[i]);
+    }
+} // namespace infini
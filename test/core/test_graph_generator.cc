@@ -0,0 +1,60 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "utils/graph_generator.h"
+
+#include "test.h"
+
+namespace infini
+{
+    static void checkGraph(const Graph &g)
+    {
+        EXPECT_TRUE(g->checkValid());
+        EXPECT_TRUE(g->topo_sort());
+        g->dataMalloc();
+        for (auto &t : g->getInputs())
+            t->setData(OneGenerator());
+        g->getRuntime()->run(g);
+    }
+
+    TEST(GraphGenerator, Transformer)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto g = makeTransformerGraph(runtime, 2, 8, 16, 2);
+        EXPECT_EQ(g->getOperators().size(), 2u * (7 * 2 + 9));
+        // x plus per layer 3 * heads + 1 + 4 weights
+        EXPECT_EQ(g->getInputs().size(), 1u + 2 * (3 * 2 + 5));
+        EXPECT_TRUE(g->getInputs()[0]->isInput());
+        for (size_t i = 1; i < g->getInputs().size(); ++i)
+            EXPECT_TRUE(g->getInputs()[i]->isWeight());
+        ASSERT_EQ(g->getOutputs().size(), 1u);
+        EXPECT_EQ(g->getOutputs()[0]->getDims(), (Shape{8, 16}));
+        checkGraph(g);
+    }
+
+    TEST(GraphGenerator, Chain)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto g = makeChainGraph(runtime, 101, {4, 4});
+        EXPECT_EQ(g->getOperators().size(), 101u);
+        EXPECT_EQ(g->getInputs().size(), 1u);
+        EXPECT_TRUE(g->getInputs()[0]->isInput());
+        checkGraph(g);
+        // relu(1) = 1 and each of the 50 Adds doubles it
+        EXPECT_TRUE(g->getOutputs()[0]->equalData(
+            vector<float>(16, std::ldexp(1.f, 50))));
+    }
+
+    TEST(GraphGenerator, FanOut)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto g = makeFanOutGraph(runtime, 8, 3, {2, 4});
+        EXPECT_EQ(g->getOperators().size(), 8u * 3 + 1);
+        EXPECT_EQ(g->getInputs()[0]->getTargets().size(), 8u);
+        EXPECT_TRUE(g->getInputs()[0]->isInput());
+        for (size_t i = 1; i < g->getInputs().size(); ++i)
+            EXPECT_TRUE(g->getInputs()[i]->isWeight());
+        ASSERT_EQ(g->getOutputs().size(), 1u);
+        EXPECT_EQ(g->getOutputs()[0]->getDims(), (Shape{2, 32}));
+        checkGraph(g);
+    }
+} // namespace infini
@@ -0,0 +1,111 @@
+#include "core/execution_context.h"
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+#include "utils/graph_generator.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(MemoryPlan, ReuseAfterLastUse)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        // 4 x 4 floats = 64 bytes per tensor
+        auto g = makeChainGraph(runtime, 10, {4, 4});
+        g->dataMalloc();
+        auto &plan = g->getMemoryPlan();
+        EXPECT_EQ(plan.getSteps(), 10);
+        EXPECT_EQ(plan.getPlacements().size(), 11u);
+        // At most the graph input, the residual, the Relu output and the Add
+        // being produced are live at once.
+        EXPECT_LT(plan.getPeak(), 11u * 64);
+        EXPECT_GE(plan.getPeak(), plan.getLowerBound());
+        EXPECT_EQ(plan.getLowerBound(), 4u * 64);
+
+        auto &input = plan.getPlacements()[0];
+        EXPECT_EQ(input.producer, "input");
+        EXPECT_EQ(input.firstUse, 0);
+        EXPECT_EQ(input.lastUse, 9);
+        auto &relu = plan.getPlacements()[1];
+        EXPECT_EQ(relu.firstUse, 0);
+        EXPECT_EQ(relu.lastUse, 1);
+        EXPECT_EQ(relu.producer.rfind("Relu[", 0), 0u);
+
+        // The output is still correct when intermediate memory is reused.
+        g->getInputs()[0]->setData(OneGenerator());
+        runtime->run(g);
+        EXPECT_TRUE(
+            g->getOutputs()[0]->equalData(vector<float>(16, 32)));
+    }
+
+    TEST(MemoryPlan, Export)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({2, 8}, DataType::Float32);
+        auto b = g->addTensor({2, 8}, DataType::Float32);
+        auto x = g->addOp<AddObj>(a, b, nullptr)->getOutput();
+        auto y = g->addOp<ReluObj>(x, nullptr)->getOutput();
+        g->addOp<MulObj>(y, a, nullptr);
+        g->dataMalloc();
+        auto &plan = g->getMemoryPlan();
+        plan.print();
+        EXPECT_EQ(plan.getWastedAtPeak(),
+                  plan.getPeak() - plan.getLiveBytes()[plan.getPeakStep()]);
+
+        auto csv = plan.toCsv();
+        EXPECT_EQ(csv.rfind("fuid,guid,offset,bytes,first_use,last_use,producer\n",
+                            0),
+                  0u);
+        EXPECT_EQ(std::count(csv.begin(), csv.end(), '\n'), 6);
+        auto json = plan.toJson();
+        EXPECT_NE(json.find("\"peak\":" + std::to_string(plan.getPeak())),
+                  string::npos);
+        EXPECT_NE(json.find("\"producer\":\"Relu["), string::npos);
+    }
+
+    TEST(MemoryPlan, Workspaces)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({2, 3, 8}, DataType::Float32);
+        auto b = g->addTensor({2, 5, 8}, DataType::Float32);
+        auto mm = g->addOp<MatmulObj>(a, b, nullptr, false, true);
+        auto y = g->addOp<ReluObj>(mm->getOutput(), nullptr)->getOutput();
+        g->dataMalloc();
+
+        // the blocked kernel packs the transposed B, live only at step 0
+        auto &plan = g->getMemoryPlan();
+        auto ws = std::find_if(plan.getPlacements().begin(),
+                               plan.getPlacements().end(),
+                               [](auto &p) { return p.isWorkspace(); });
+        ASSERT_NE(ws, plan.getPlacements().end());
+        EXPECT_EQ(ws->guid, mm->getGuid());
+        EXPECT_GE(ws->bytes, b->getBytes());
+        EXPECT_EQ(ws->firstUse, 0);
+        EXPECT_EQ(ws->lastUse, 0);
+        EXPECT_EQ(g->getWorkspaceSize(mm), b->getBytes());
+        auto workspace = g->getWorkspace(mm);
+        ASSERT_NE(workspace, nullptr);
+        EXPECT_EQ(g->getWorkspace(g->getOperators()[1]), nullptr);
+
+        a->setData(IncrementalGenerator());
+        b->setData(IncrementalGenerator());
+        runtime->run(g);
+        vector<float> expected(y->getRawDataPtr<float *>(),
+                               y->getRawDataPtr<float *>() + y->size());
+        auto blocked = KernelRegistry::getInstance().getKernelItem(
+            KernelAttrs{Device::CPU, OpType::MatMul}, "MatmulBlocked_CPU");
+        ASSERT_NE(blocked, nullptr);
+        std::get<0>(*blocked)->compute(mm, workspace, runtime.get());
+        EXPECT_TRUE(mm->getOutput()->equalData(expected));
+
+        ExecutionContext context(g);
+        EXPECT_NE(context.getWorkspace(mm->getGuid()), nullptr);
+        EXPECT_NE(context.getWorkspace(mm->getGuid()), workspace);
+    }
+} // namespace infini
@@ -0,0 +1,137 @@
+#include "core/graph.h"
+#include "core/numa.h"
+#include "core/runtime.h"
+#include "operators/unary.h"
+#include <mutex>
+#include <sched.h>
+#include <thread>
+#include <unistd.h>
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(Numa, ParseCpuList)
+    {
+        EXPECT_EQ(NumaTopology::parseCpuList("0-3,8,10-11\n"),
+                  (vector<int>{0, 1, 2, 3, 8, 10, 11}));
+        EXPECT_EQ(NumaTopology::parseCpuList("5"), vector<int>{5});
+        EXPECT_TRUE(NumaTopology::parseCpuList("").empty());
+    }
+
+    TEST(Numa, Affinity)
+    {
+        NumaTopology topology({{1, {4, 5, 6}}, {0, {0, 1, 2}}});
+        EXPECT_EQ(topology.getNodes()[0].id, 0);
+        EXPECT_EQ(topology.getCpus(Affinity::Compact),
+                  (vector<int>{0, 1, 2, 4, 5, 6}));
+        EXPECT_EQ(topology.getCpus(Affinity::Scatter),
+                  (vector<int>{0, 4, 1, 5, 2, 6}));
+        EXPECT_EQ(topology.getCpus(Affinity::Scatter, 1),
+                  (vector<int>{4, 5, 6}));
+        EXPECT_TRUE(topology.getCpus(Affinity::None).empty());
+        EXPECT_THROW(topology.getCpus(Affinity::Compact, 2), Exception);
+    }
+
+    TEST(Numa, NodeRuntime)
+    {
+        auto &topology = NumaTopology::get();
+        ASSERT_GT(topology.getNodeCount(), 0);
+        int node = topology.getNodes()[0].id;
+        auto runtime = NativeCpuRuntimeObj::getInstance(node);
+        EXPECT_EQ(runtime, NativeCpuRuntimeObj::getInstance(node));
+        EXPECT_EQ(runtime->getNumaNode(), node);
+        EXPECT_THROW(make_ref<NativeCpuRuntimeObj>(1 << 20), Exception);
+
+        void *ptr = runtime->alloc(100);
+        EXPECT_EQ((size_t)ptr % sysconf(_SC_PAGESIZE), 0u);
+        runtime->dealloc(ptr);
+
+        auto report = runtime->getTopologyReport();
+        EXPECT_NE(report.find("NUMA node"), string::npos);
+        EXPECT_NE(report.find("runtime node: " + std::to_string(node)),
+                  string::npos);
+    }
+
+    TEST(Numa, PinnedRun)
+    {
+        auto &topology = NumaTopology::get();
+        int node = topology.getNodes()[0].id;
+        auto runtime = make_ref<NativeCpuRuntimeObj>(node);
+        runtime->setAffinity(Affinity::Compact);
+        EXPECT_NE(runtime->getTopologyReport().find("affinity: compact"),
+                  string::npos);
+
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({4, 8}, DataType::Float32);
+        auto y = g->addOp<ReluObj>(x, nullptr)->getOutput();
+        g->dataMalloc();
+
+        // run on a separate thread, so the test thread stays unpinned
+        cpu_set_t set;
+        float out = 0;
+        std::thread thread(
+            [&]
+            {
+                x->setData(OneGenerator());
+                runtime->run(g);
+                out = y->getRawDataPtr<float *>()[0];
+                sched_getaffinity(0, sizeof(set), &set);
+            });
+        thread.join();
+        EXPECT_EQ(out, 1);
+        // the caller is kept on the CPUs of all threads of the node
+        auto cpus = topology.getCpus(Affinity::Compact, node);
+        EXPECT_EQ(CPU_COUNT(&set), (int)cpus.size());
+        for (int cpu : cpus)
+            EXPECT_TRUE(CPU_ISSET(cpu, &set));
+        EXPECT_EQ(runtime->getThreadCount(), (int)cpus.size());
+    }
+
+    TEST(Numa, UnpinnedAfterPinned)
+    {
+        auto runtime = make_ref<NativeCpuRuntimeObj>();
+        runtime->setThreadCount(4);
+        Graph g = make_ref<GraphObj>(runtime);
+        // the CPU counts of the masks of the threads running a loop,
+        // the caller's first
+        auto getMasks = [&]
+        {
+            vector<int> masks;
+            std::mutex mutex;
+            std::thread thread(
+                [&]
+                {
+                    runtime->run(g);
+                    cpu_set_t set;
+                    sched_getaffinity(0, sizeof(set), &set);
+                    masks.emplace_back(CPU_COUNT(&set));
+                    auto caller = std::this_thread::get_id();
+                    runtime->parallel_for(
+                        0, 64, 1,
+                        [&](size_t, size_t)
+                        {
+                            if (std::this_thread::get_id() == caller)
+                                return;
+                            cpu_set_t set;
+                            sched_getaffinity(0, sizeof(set), &set);
+                            std::lock_guard<std::mutex> lock(mutex);
+                            masks.emplace_back(CPU_COUNT(&set));
+                        });
+                });
+            thread.join();
+            return masks;
+        };
+
+        int all = NumaTopology::get().getCpus(Affinity::Compact).size();
+        runtime->setAffinity(Affinity::Compact);
+        auto masks = getMasks();
+        EXPECT_EQ(masks[0], all);
+        for (size_t i = 1; i < masks.size(); ++i)
+            EXPECT_EQ(masks[i], 1);
+
+        runtime->setAffinity(Affinity::None);
+        for (int mask : getMasks())
+            EXPECT_EQ(mask, all);
+    }
+} // namespace infini
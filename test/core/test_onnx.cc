@@ -0,0 +1,202 @@
+#include "core/graph.h"
+#include "core/onnx.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    namespace
+    {
+        // Just enough of the protobuf encoder to write ONNX models by hand.
+        class Proto
+        {
+            string buf;
+
+            void raw(uint64_t v)
+            {
+                do
+                {
+                    buf += char((v & 0x7f) | (v > 0x7f ? 0x80 : 0));
+                    v >>= 7;
+                } while (v);
+            }
+
+        public:
+            Proto &varint(int field, int64_t v)
+            {
+                raw(uint64_t(field) << 3);
+                raw(v);
+                return *this;
+            }
+            Proto &bytes(int field, const string &s)
+            {
+                raw(uint64_t(field) << 3 | 2);
+                raw(s.size());
+                buf += s;
+                return *this;
+            }
+            Proto &msg(int field, const Proto &p) { return bytes(field, p.buf); }
+            const string &str() const { return buf; }
+        };
+
+        string floatBytes(const vector<float> &vals)
+        {
+            return string(reinterpret_cast<const char *>(vals.data()),
+                          vals.size() * sizeof(float));
+        }
+
+        Proto valueInfo(const string &name, const vector<int64_t> &dims)
+        {
+            Proto shape;
+            for (auto d : dims)
+                shape.msg(1, d < 0 ? Proto().bytes(2, "batch")
+                                   : Proto().varint(1, d));
+            return Proto().bytes(1, name).msg(
+                2, Proto().msg(1, Proto().varint(1, 1).msg(2, shape)));
+        }
+
+        Proto node(const string &type, const vector<string> &inputs,
+                   const string &output)
+        {
+            Proto p;
+            for (auto &i : inputs)
+                p.bytes(1, i);
+            return p.bytes(2, output).bytes(4, type);
+        }
+
+        void writeModel(const string &path, const Proto &graph)
+        {
+            auto model = Proto().varint(1, 8).msg(7, graph);
+            std::ofstream(path, std::ios::binary) << model.str();
+        }
+    } // namespace
+
+    TEST(Onnx, Import)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto dir = ::testing::TempDir();
+        vector<float> w(12), x(6);
+        for (size_t i = 0; i < w.size(); ++i)
+            w[i] = i;
+        for (size_t i = 0; i < x.size(); ++i)
+            x[i] = i;
+        // W lives at offset 16 of an external file
+        std::ofstream(dir + "onnx_test.bin", std::ios::binary)
+            << string(16, '\0') << floatBytes(w);
+
+        Proto weight;
+        weight.varint(1, 3).varint(1, 4).varint(2, 1).bytes(8, "W");
+        weight.msg(13, Proto().bytes(1, "location").bytes(2, "onnx_test.bin"))
+            .msg(13, Proto().bytes(1, "offset").bytes(2, "16"))
+            .msg(13, Proto().bytes(1, "length").bytes(2, "48"))
+            .varint(14, 1);
+        Proto bias;
+        bias.varint(1, 4).varint(2, 1).bytes(
+            4, floatBytes({1, 1, 1, 1})); // packed float_data
+        bias.bytes(8, "B");
+        auto hi = Proto().varint(2, 1).bytes(8, "hi").bytes(9, floatBytes({20}));
+        auto unused =
+            Proto().varint(1, 2).varint(2, 1).bytes(8, "unused").bytes(
+                9, floatBytes({0, 0}));
+
+        Proto graph;
+        graph.msg(1, node("Gemm", {"X", "W", "B"}, "Y"))
+            .msg(1, node("Relu", {"Y"}, "R"))
+            .msg(1, node("Clip", {"R", "", "hi"}, "C"))
+            .msg(1, node("Transpose", {"C"}, "T"))
+            .msg(1, node("Concat", {"T", "T"}, "out")
+                        .msg(5, Proto().bytes(1, "axis").varint(3, -1)))
+            .msg(5, weight)
+            .msg(5, bias)
+            .msg(5, hi)
+            .msg(5, unused)
+            .msg(11, valueInfo("X", {2, 3}))
+            .msg(12, valueInfo("out", {4, 4}));
+        writeModel(dir + "onnx_test.onnx", graph);
+
+        auto g = importOnnx(dir + "onnx_test.onnx", runtime);
+        ASSERT_EQ(g->getOperators().size(), 6u); // Gemm is MatMul + Add
+        EXPECT_EQ(g->getOperators()[0]->getOpType(), OpType::MatMul);
+        EXPECT_EQ(g->getOperators()[1]->getOpType(), OpType::Add);
+        auto clip = as<ClipObj>(g->getOperators()[3]);
+        EXPECT_FALSE(clip->getMin().has_value());
+        EXPECT_EQ(clip->getMax(), 20.f);
+        auto inputs = g->getInputs();
+        ASSERT_EQ(inputs.size(), 3u); // X, W and B
+        EXPECT_TRUE(inputs[0]->isInput());
+        EXPECT_TRUE(inputs[1]->isWeight() && inputs[1]->hasData());
+        EXPECT_TRUE(inputs[2]->isWeight() && inputs[2]->hasData());
+
+        g->dataMalloc();
+        inputs[0]->setData(IncrementalGenerator());
+        runtime->run(g);
+        auto out = g->getOutputs()[0];
+        ASSERT_EQ(out->getDims(), (Shape{4, 4}));
+        auto result = out->getRawDataPtr<float *>();
+        for (int i = 0; i < 2; ++i)
+            for (int j = 0; j < 4; ++j)
+            {
+                float y = 1;
+                for (int k = 0; k < 3; ++k)
+                    y += x[i * 3 + k] * w[k * 4 + j];
+                y = std::min(std::max(y, 0.f), 20.f);
+                EXPECT_EQ(result[j * 4 + i], y);
+                EXPECT_EQ(result[j * 4 + i + 2], y);
+            }
+    }
+
+    TEST(Onnx, SymbolicInputShape)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto path = ::testing::TempDir() + "onnx_symbolic.onnx";
+        auto weight = Proto().varint(1, 3).varint(1, 2).varint(2, 1).bytes(
+            8, "W").bytes(9, floatBytes({1, 2, 3, 4, 5, 6}));
+        writeModel(path, Proto()
+                             .msg(1, node("MatMul", {"X", "W"}, "Y"))
+                             .msg(1, node("Cast", {"Y"}, "Z").msg(
+                                         5, Proto().bytes(1, "to").varint(3, 7)))
+                             .msg(5, weight)
+                             .msg(11, valueInfo("X", {-1, 3})));
+        EXPECT_THROW(importOnnx(path, runtime), Exception);
+
+        auto g = importOnnx(path, runtime, {{"X", {5, 3}}});
+        auto matmul = as<MatmulObj>(g->getOperators()[0]);
+        EXPECT_EQ(matmul->getOutput()->getDims(), (Shape{5, 2}));
+        auto cast = as<CastObj>(g->getOperators()[1]);
+        EXPECT_EQ(cast->getType(), CastType::Float2Int64);
+        EXPECT_EQ(cast->getOutput()->getDType(), DataType::Int64);
+    }
+
+    TEST(Onnx, RejectUnsupported)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto path = ::testing::TempDir() + "onnx_unsupported.onnx";
+        writeModel(path, Proto()
+                             .msg(1, node("Softmax", {"X"}, "Y"))
+                             .msg(11, valueInfo("X", {2, 3})));
+        EXPECT_THROW(importOnnx(path, runtime), Exception);
+        std::ofstream(path, std::ios::binary) << "\xff\xff\xff";
+        EXPECT_THROW(importOnnx(path, runtime), Exception);
+        EXPECT_THROW(importOnnx(path + ".missing", runtime), Exception);
+
+        // element types outside DataType, or without a size
+        for (int64_t type : {0, 14, 17, 1 << 20})
+        {
+            writeModel(path, Proto()
+                                 .msg(1, node("Cast", {"X"}, "Y").msg(
+                                             5, Proto().bytes(1, "to").varint(
+                                                    3, type)))
+                                 .msg(11, valueInfo("X", {2, 3})));
+            EXPECT_THROW(importOnnx(path, runtime), Exception);
+            auto weight = Proto().varint(1, 2).varint(2, type).bytes(8, "W");
+            writeModel(path, Proto()
+                                 .msg(1, node("Add", {"X", "W"}, "Y"))
+                                 .msg(5, weight)
+                                 .msg(11, valueInfo("X", {2})));
+            EXPECT_THROW(importOnnx(path, runtime), Exception);
+        }
+    }
+} // namespace infini
@@ -0,0 +1,106 @@
+#include "core/execution_context.h"
+#include "core/graph.h"
+#include "core/profiler.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+
+#include "test.h"
+#include <fstream>
+#include <set>
+#include <thread>
+
+namespace infini
+{
+    TEST(Profiler, RecordAndExport)
+    {
+        Runtime runtime = make_ref<NativeCpuRuntimeObj>();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({4, 8}, DataType::Float32);
+        auto b = g->addTensor({8, 16}, DataType::Float32);
+        auto c = g->addTensor({4, 16}, DataType::Float32);
+        auto mm = g->addOp<MatmulObj>(a, b, nullptr);
+        auto add = g->addOp<AddObj>(mm->getOutput(), c, nullptr);
+        g->dataMalloc();
+        a->setData(IncrementalGenerator());
+        b->setData(IncrementalGenerator());
+        c->setData(IncrementalGenerator());
+
+        EXPECT_FALSE(runtime->isProfiling());
+        runtime->setProfiling(true);
+        runtime->run(g);
+        runtime->run(g);
+        auto &profiler = runtime->getProfiler();
+        auto records = profiler.getRecords();
+        ASSERT_EQ(records.size(), 4u);
+        EXPECT_EQ(records[0].guid, mm->getGuid());
+        EXPECT_EQ(records[0].kernel, "MatmulNaive_CPU");
+        EXPECT_EQ(records[0].bytesRead, (4 * 8 + 8 * 16) * sizeof(float));
+        EXPECT_EQ(records[0].bytesWritten, 4 * 16 * sizeof(float));
+        EXPECT_EQ(records[0].flops, 2.0 * 4 * 8 * 16);
+        EXPECT_EQ(records[1].type, OpType::Add);
+        EXPECT_EQ(records[1].flops, 0);
+        EXPECT_EQ(records[0].thread, 0);
+        EXPECT_LE(records[0].begin + records[0].duration, records[1].begin);
+
+        auto types = profiler.aggregate();
+        ASSERT_EQ(types.size(), 2u);
+        for (auto &t : types)
+            EXPECT_EQ(t.count, 2u);
+        EXPECT_GE(types[0].duration, types[1].duration);
+        profiler.printSummary();
+
+        auto path = ::testing::TempDir() + "profile_trace.json";
+        profiler.exportChromeTrace(path);
+        std::ifstream ifs(path);
+        std::string json((std::istreambuf_iterator<char>(ifs)),
+                         std::istreambuf_iterator<char>());
+        EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0u);
+        EXPECT_NE(json.find("\"kernel\":\"MatmulNaive_CPU\""), std::string::npos);
+
+        runtime->setProfiling(false);
+        EXPECT_FALSE(runtime->isProfiling());
+    }
+
+    TEST(Profiler, ConcurrentContexts)
+    {
+        Runtime runtime = make_ref<NativeCpuRuntimeObj>();
+        runtime->setThreadCount(1);
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({4, 8}, DataType::Float32);
+        auto b = g->addTensor({8, 16}, DataType::Float32);
+        b->setWeight();
+        g->addOp<MatmulObj>(a, b, nullptr);
+        g->dataMalloc();
+        b->setData(OneGenerator());
+        runtime->setProfiling(true);
+        auto &profiler = runtime->getProfiler();
+
+        constexpr int kThreads = 4, kRuns = 50;
+        vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t)
+            threads.emplace_back(
+                [&]
+                {
+                    ExecutionContext context(g);
+                    for (int i = 0; i < kRuns; ++i)
+                    {
+                        context.run();
+                        // readers run while other threads record
+                        profiler.aggregate();
+                    }
+                });
+        for (auto &thread : threads)
+            thread.join();
+
+        auto records = profiler.getRecords();
+        ASSERT_EQ(records.size(), size_t(kThreads * kRuns));
+        std::set<int> ids;
+        for (auto &r : records)
+            ids.insert(r.thread);
+        EXPECT_EQ(ids, (std::set<int>{0, 1, 2, 3}));
+        profiler.clear();
+        runtime->run(g);
+        EXPECT_EQ(profiler.getRecords()[0].thread, 0);
+    }
+} // namespace infini
@@ -0,0 +1,137 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    namespace
+    {
+        // a = Relu(x) is only read after a wide MatMul
+        Graph makeGraph(Runtime runtime)
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({64, 64}, DataType::Float32);
+            auto w1 = g->addTensor({64, 512}, DataType::Float32);
+            auto w2 = g->addTensor({512, 64}, DataType::Float32);
+            w1->setWeight();
+            w2->setWeight();
+            auto a = g->addOp<ReluObj>(x, nullptr)->getOutput();
+            auto b = g->addOp<MatmulObj>(x, w1, nullptr)->getOutput();
+            auto c = g->addOp<MatmulObj>(b, w2, nullptr)->getOutput();
+            g->addOp<AddObj>(c, a, nullptr);
+            return g;
+        }
+
+        vector<float> run(Runtime runtime, const Graph &g)
+        {
+            g->dataMalloc();
+            for (auto &t : g->getInputs())
+                t->setData(IncrementalGenerator());
+            runtime->run(g);
+            auto out = g->getOutputs()[0];
+            auto ptr = out->getRawDataPtr<float *>();
+            return vector<float>(ptr, ptr + out->size());
+        }
+    } // namespace
+
+    TEST(Rematerialization, FitsBudget)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto g = makeGraph(runtime);
+        auto expected = run(runtime, g);
+        size_t peak = g->getMemoryPlan().getPeak();
+
+        auto report = g->rematerialize(peak - 1);
+        EXPECT_EQ(report.peakBefore, peak);
+        EXPECT_LT(report.peakAfter, peak);
+        EXPECT_TRUE(report.fits());
+        EXPECT_EQ(report.recomputed, 1);
+        EXPECT_EQ(report.extraCost, 64u * 64);
+        ASSERT_EQ(report.decisions.size(), 1u);
+        EXPECT_TRUE(g->checkValid());
+
+        // Relu is no longer needed early and runs right before the Add
+        auto &ops = g->getOperators();
+        ASSERT_EQ(ops.size(), 4u);
+        EXPECT_EQ(ops[2]->getOpType(), OpType::Relu);
+        EXPECT_EQ(ops[3]->getInputs(1), ops[2]->getOutput());
+        EXPECT_EQ(run(runtime, g), expected);
+        EXPECT_EQ(g->getMemoryPlan().getPeak(), report.peakAfter);
+    }
+
+    TEST(Rematerialization, WithinOrOverBudget)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto g = makeGraph(runtime);
+        g->dataMalloc();
+        size_t peak = g->getMemoryPlan().getPeak();
+
+        auto report = g->rematerialize(peak);
+        EXPECT_TRUE(report.fits());
+        EXPECT_EQ(report.recomputed, 0);
+        EXPECT_EQ(g->getOperators().size(), 4u);
+
+        // the wide MatMul output can not be recomputed cheaply
+        report = g->rematerialize(0);
+        EXPECT_FALSE(report.fits());
+        EXPECT_LT(report.peakAfter, peak);
+        EXPECT_NE(report.toString().find("does not fit"), string::npos);
+    }
+
+    TEST(Rematerialization, KeepsEarlyUses)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({64, 64}, DataType::Float32);
+        auto w1 = g->addTensor({64, 512}, DataType::Float32);
+        auto w2 = g->addTensor({512, 64}, DataType::Float32);
+        w1->setWeight();
+        w2->setWeight();
+        auto a = g->addOp<ReluObj>(x, nullptr)->getOutput();
+        auto b = g->addOp<AddObj>(a, x, nullptr)->getOutput();
+        auto c = g->addOp<MatmulObj>(b, w1, nullptr)->getOutput();
+        auto d = g->addOp<MatmulObj>(c, w2, nullptr)->getOutput();
+        g->addOp<AddObj>(d, a, nullptr);
+        auto expected = run(runtime, g);
+
+        auto report = g->rematerialize(g->getMemoryPlan().getPeak() - 1);
+        EXPECT_EQ(report.recomputed, 1);
+        EXPECT_TRUE(g->checkValid());
+        // the first Relu still feeds the first Add, a copy feeds the last
+        auto &ops = g->getOperators();
+        ASSERT_EQ(ops.size(), 6u);
+        EXPECT_EQ(ops[1]->getInputs(0), a);
+        EXPECT_EQ(ops[4]->getOpType(), OpType::Relu);
+        EXPECT_EQ(ops[5]->getInputs(1), ops[4]->getOutput());
+        EXPECT_EQ(run(runtime, g), expected);
+    }
+
+    TEST(Rematerialization, SkipsGraphOutputs)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({64, 64}, DataType::Float32);
+        auto w1 = g->addTensor({64, 512}, DataType::Float32);
+        auto w2 = g->addTensor({512, 64}, DataType::Float32);
+        w1->setWeight();
+        w2->setWeight();
+        // a is an output produced before the peak, live to the end
+        auto a = g->addOp<ReluObj>(x, nullptr)->getOutput();
+        auto b = g->addOp<MatmulObj>(x, w1, nullptr)->getOutput();
+        auto c = g->addOp<MatmulObj>(b, w2, nullptr)->getOutput();
+        g->addOp<ReluObj>(c, nullptr);
+        g->dataMalloc();
+
+        auto report = g->rematerialize(g->getMemoryPlan().getPeak() - 1);
+        EXPECT_EQ(report.recomputed, 0);
+        EXPECT_FALSE(report.fits());
+        EXPECT_TRUE(g->checkValid());
+        EXPECT_EQ(g->getOperators().size(), 4u);
+        EXPECT_EQ(a->getSource(), g->getOperators()[0]);
+        EXPECT_EQ(g->getOutputs().size(), 2u);
+    }
+} // namespace infini
@@ -0,0 +1,105 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "core/scheduler.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include <numeric>
+
+#include "test.h"
+
+namespace infini
+{
+    namespace
+    {
+        // `branches` branches of x [4, 4] -> [4, 256] -> [4, 4], summed. Ops
+        // are added stage by stage, so the default order keeps every wide
+        // tensor live at once.
+        Graph makeBranchyGraph(Runtime runtime, int branches)
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({4, 4}, DataType::Float32);
+            TensorVec wide, narrow;
+            for (int i = 0; i < branches; ++i)
+            {
+                auto w = g->addTensor({4, 256}, DataType::Float32);
+                w->setWeight();
+                wide.emplace_back(g->addOp<MatmulObj>(x, w, nullptr)->getOutput());
+            }
+            for (int i = 0; i < branches; ++i)
+            {
+                auto w = g->addTensor({256, 4}, DataType::Float32);
+                w->setWeight();
+                narrow.emplace_back(
+                    g->addOp<MatmulObj>(wide[i], w, nullptr)->getOutput());
+            }
+            auto sum = narrow[0];
+            for (int i = 1; i < branches; ++i)
+                sum = g->addOp<AddObj>(sum, narrow[i], nullptr)->getOutput();
+            return g;
+        }
+
+        bool isTopological(const Graph &g)
+        {
+            std::unordered_set<Operator> done;
+            for (auto &op : g->getOperators())
+            {
+                for (auto &pred : op->getPredecessors())
+                    if (!done.count(pred))
+                        return false;
+                done.insert(op);
+            }
+            return true;
+        }
+
+        size_t getPeak(const Graph &g)
+        {
+            auto &topo = g->getTopology();
+            vector<size_t> bytes(topo.getTensorCount());
+            for (int t = 0; t < topo.getTensorCount(); ++t)
+                bytes[t] = topo.getTensor(t)->getBytes();
+            vector<int> order(topo.getOpCount());
+            std::iota(order.begin(), order.end(), 0);
+            return getPeakLiveBytes(topo, order, bytes);
+        }
+    } // namespace
+
+    TEST(Scheduler, MinMemory)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        // 11 operators are scheduled exactly, 35 greedily
+        for (int branches : {4, 12})
+        {
+            auto g = makeBranchyGraph(runtime, branches);
+            g->dataMalloc();
+            size_t defaultPeak = getPeak(g);
+            // all wide tensors and the first narrow one
+            EXPECT_EQ(defaultPeak, branches * 4096u + 64);
+            size_t defaultArena = g->getMemoryPlan().getPeak();
+
+            ASSERT_TRUE(g->schedule(ScheduleGoal::MinMemory));
+            EXPECT_TRUE(isTopological(g));
+            // one wide tensor and the narrow ones at most
+            EXPECT_LE(getPeak(g), 4096u + branches * 64u);
+            g->dataMalloc();
+            EXPECT_LT(g->getMemoryPlan().getPeak(), defaultArena / 2);
+        }
+    }
+
+    TEST(Scheduler, MaxParallelism)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto g = makeBranchyGraph(runtime, 3);
+        ASSERT_TRUE(g->schedule(ScheduleGoal::MinMemory));
+        ASSERT_TRUE(g->schedule(ScheduleGoal::MaxParallelism));
+        EXPECT_TRUE(isTopological(g));
+        // the wide and the narrow matmuls of all branches are adjacent
+        auto &ops = g->getOperators();
+        for (int i = 0; i < 6; ++i)
+        {
+            ASSERT_EQ(ops[i]->getOpType(), OpType::MatMul);
+            EXPECT_EQ(ops[i]->getPredecessors().empty(), i < 3);
+        }
+        ASSERT_TRUE(g->schedule(ScheduleGoal::Default));
+        EXPECT_TRUE(isTopological(g));
+    }
+} // namespace infini
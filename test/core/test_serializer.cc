@@ -0,0 +1,105 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "core/serializer.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(Serializer, SaveAndLoad)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({2, 3}, DataType::Float32);
+        auto w = g->addTensor({4, 3}, DataType::Float32);
+        auto bias = g->addTensor({4}, DataType::Float32);
+        x->setInput();
+        w->setWeight();
+        bias->setWeight();
+        auto y = g->addOp<MatmulObj>(x, w, nullptr, false, true)->getOutput();
+        y = g->addOp<AddObj>(y, bias, nullptr)->getOutput();
+        y = g->addOp<ClipObj>(y, nullptr, std::nullopt, 20.f)->getOutput();
+        auto t = g->addOp<TransposeObj>(y, nullptr, vector<int>{1, 0})
+                     ->getOutput();
+        g->addOp<ConcatObj>(TensorVec{t, t}, nullptr, -1);
+        g->dataMalloc();
+        x->setData(IncrementalGenerator());
+        w->setData(IncrementalGenerator());
+        bias->setData(OneGenerator());
+        runtime->run(g);
+
+        auto path = ::testing::TempDir() + "serializer_test.itg";
+        saveGraph(g, path);
+        auto loaded = loadGraph(path, runtime);
+        ASSERT_EQ(loaded->getTensors().size(), g->getTensors().size());
+        ASSERT_EQ(loaded->getOperators().size(), g->getOperators().size());
+        for (size_t i = 0; i < g->getOperators().size(); ++i)
+            EXPECT_EQ(loaded->getOperators()[i]->getOpType(),
+                      g->getOperators()[i]->getOpType());
+        auto matmul = as<MatmulObj>(loaded->getOperators()[0]);
+        EXPECT_FALSE(matmul->getTransA());
+        EXPECT_TRUE(matmul->getTransB());
+        auto clip = as<ClipObj>(loaded->getOperators()[2]);
+        EXPECT_FALSE(clip->getMin().has_value());
+        EXPECT_EQ(clip->getMax(), 20.f);
+
+        // Weights are bound to the mapping, aligned and left out of the arena.
+        auto lx = loaded->getTensors()[0], lw = loaded->getTensors()[1],
+             lb = loaded->getTensors()[2];
+        EXPECT_TRUE(lx->isInput());
+        EXPECT_FALSE(lx->hasData());
+        EXPECT_TRUE(lw->isWeight());
+        ASSERT_TRUE(lw->hasData());
+        EXPECT_EQ((uintptr_t)lw->getRawDataPtr<void *>() % kWeightAlignment, 0u);
+        EXPECT_EQ((uintptr_t)lb->getRawDataPtr<void *>() % kWeightAlignment, 0u);
+        EXPECT_TRUE(lw->equalData(w));
+        auto weightPtr = lw->getRawDataPtr<void *>();
+        loaded->dataMalloc();
+        EXPECT_EQ(lw->getRawDataPtr<void *>(), weightPtr);
+        // the transposed B of the MatMul is packed in a workspace
+        auto &placements = loaded->getMemoryPlan().getPlacements();
+        EXPECT_EQ(std::count_if(placements.begin(), placements.end(),
+                                [](auto &p) { return !p.isWorkspace(); }),
+                  loaded->getTensors().size() - 2);
+        EXPECT_NE(loaded->getWorkspace(matmul), nullptr);
+
+        lx->setData(IncrementalGenerator());
+        runtime->run(loaded);
+        EXPECT_TRUE(loaded->getOutputs()[0]->equalData(g->getOutputs()[0]));
+    }
+
+    TEST(Serializer, RejectInvalidFile)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto path = ::testing::TempDir() + "serializer_invalid.itg";
+        std::ofstream(path) << "not a model file, but long enough for a header";
+        EXPECT_THROW(loadGraph(path, runtime), Exception);
+        EXPECT_THROW(loadGraph(path + ".missing", runtime), Exception);
+
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({2, 3}, DataType::Float32);
+        x->setInput();
+        g->addOp<ReluObj>(x, nullptr);
+        saveGraph(g, path);
+        std::ifstream ifs(path, std::ios::binary);
+        string valid{std::istreambuf_iterator<char>(ifs), {}};
+        // the first tensor's dtype, tensor type and dim count follow the
+        // 48-byte header
+        auto corrupt = [&](size_t offset, const string &bytes)
+        {
+            auto data = valid;
+            data.replace(offset, bytes.size(), bytes);
+            std::ofstream(path, std::ios::binary) << data;
+            EXPECT_THROW(loadGraph(path, runtime), Exception);
+        };
+        corrupt(48, string("\x63\0\0\0", 4));
+        corrupt(48, string("\0\0\0\0", 4));
+        corrupt(52, "\x09");
+        corrupt(53, "\xff\xff\xff\xff");
+    }
+} // namespace infini
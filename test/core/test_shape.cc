@@ -0,0 +1,85 @@
+#include "core/runtime.h"
+#include "core/tensor.h"
+#include "utils/operator_utils.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(Shape, VectorInterface)
+    {
+        Shape a{2, 3, 4};
+        EXPECT_EQ(a.size(), 3u);
+        EXPECT_EQ(a, (Shape{2, 3, 4}));
+        EXPECT_NE(a, (Shape{2, 3}));
+        EXPECT_LT((Shape{2, 3}), a);
+        EXPECT_EQ(vecToString(a), "[2,3,4]");
+
+        a.insert(a.begin(), 1);
+        a.push_back(5);
+        EXPECT_EQ(a, (Shape{1, 2, 3, 4, 5}));
+        a.erase(a.begin() + 1, a.begin() + 3);
+        EXPECT_EQ(a, (Shape{1, 4, 5}));
+        a.resize(5, 7);
+        EXPECT_EQ(a, (Shape{1, 4, 5, 7, 7}));
+        EXPECT_EQ(Shape(a.rbegin(), a.rend()), (Shape{7, 7, 5, 4, 1}));
+        EXPECT_EQ(Shape(3, 1), (Shape{1, 1, 1}));
+
+        // inserting an element of the vector itself, shifted by the insert
+        Shape b{1, 2, 3};
+        b.insert(b.begin(), b[2]);
+        EXPECT_EQ(b, (Shape{3, 1, 2, 3}));
+        b.insert(b.begin() + 1, b.back());
+        EXPECT_EQ(b, (Shape{3, 3, 1, 2, 3}));
+
+        // conversions for interfaces taking vectors
+        vector<int> v = a;
+        EXPECT_EQ(Shape(v), a);
+        EXPECT_EQ(a, v);
+    }
+
+    TEST(Shape, Capacity)
+    {
+        Shape a(kMaxRank, 1);
+        EXPECT_THROW(a.push_back(1), Exception);
+        EXPECT_THROW(Shape(kMaxRank + 1, 1), Exception);
+        EXPECT_THROW(a.at(kMaxRank), Exception);
+    }
+
+    TEST(Shape, TensorDims)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto t = make_ref<TensorObj>(Shape{2, 3}, DataType::Float32, runtime);
+        // getDims refers to the shape of the tensor
+        auto &dims = t->getDims();
+        t->setShape({4, 5, 6});
+        EXPECT_EQ(dims, (Shape{4, 5, 6}));
+        EXPECT_EQ(t->size(), 120u);
+    }
+
+    TEST(Shape, LargeTensor)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        // no data is allocated, only the element count is checked
+        auto t = make_ref<TensorObj>(Shape{65536, 65536}, DataType::Float32,
+                                     runtime);
+        EXPECT_EQ(t->size(), 4294967296u);
+        EXPECT_EQ(t->getBytes(), 17179869184u);
+
+        Shape shape{3, 65536, 65536};
+        auto stride = get_stride(shape);
+        EXPECT_EQ(stride, (Stride{4294967296, 65536, 1}));
+        size_t last = 3 * 4294967296 - 1;
+        auto index = locate_index(last, shape);
+        EXPECT_EQ(index, (Shape{2, 65535, 65535}));
+        EXPECT_EQ(delocate_index(index, shape, stride), last);
+
+        size_t width = 0;
+        dispatch_index(size_t(1) << 31, [&](auto zero)
+                       { width = sizeof(zero); });
+        EXPECT_EQ(width, 8u);
+        dispatch_index((size_t(1) << 31) - 1, [&](auto zero)
+                       { width = sizeof(zero); });
+        EXPECT_EQ(width, 4u);
+    }
+} // namespace infini
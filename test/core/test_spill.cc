@@ -0,0 +1,153 @@
+#include "core/execution_context.h"
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/unary.h"
+#include <unistd.h>
+
+#include "test.h"
+
+namespace infini
+{
+    namespace
+    {
+        // A chain of Relu and Add over tensors of several pages, with a
+        // weight w, so intermediate tensors die at every step.
+        Graph makeGraph(Runtime runtime, int length)
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({64, 1024}, DataType::Float32);
+            auto w = g->addTensor({64, 1024}, DataType::Float32);
+            x->setInput();
+            w->setWeight();
+            auto y = x;
+            for (int i = 0; i < length; ++i)
+            {
+                y = g->addOp<ReluObj>(y, nullptr)->getOutput();
+                y = g->addOp<AddObj>(y, w, nullptr)->getOutput();
+            }
+            return g;
+        }
+
+        vector<float> run(Runtime runtime, const Graph &g)
+        {
+            g->getInputs()[0]->setData(IncrementalGenerator());
+            g->getInputs()[1]->setData(OneGenerator());
+            runtime->run(g);
+            auto out = g->getOutputs()[0];
+            auto ptr = out->getRawDataPtr<float *>();
+            return vector<float>(ptr, ptr + out->size());
+        }
+    } // namespace
+
+    TEST(Spill, MatchesInMemory)
+    {
+        auto expected = [&]
+        {
+            Runtime runtime = make_ref<NativeCpuRuntimeObj>();
+            auto g = makeGraph(runtime, 4);
+            g->dataMalloc();
+            EXPECT_TRUE(g->getPageHints().empty());
+            return run(runtime, g);
+        }();
+        EXPECT_EQ(expected[5], 9);
+
+        auto cpu = make_ref<NativeCpuRuntimeObj>();
+        cpu->setSpillDirectory(::testing::TempDir());
+        Runtime runtime = cpu;
+        auto g = makeGraph(runtime, 4);
+        g->dataMalloc();
+        auto x = g->getInputs()[0];
+        EXPECT_FALSE(g->getPageHints().empty());
+        EXPECT_TRUE(g->getWeightArena());
+        // twice, as dropped pages of intermediate tensors are written again
+        EXPECT_EQ(run(runtime, g), expected);
+        EXPECT_EQ(run(runtime, g), expected);
+
+        ExecutionContext context(g);
+        EXPECT_TRUE(cpu->isSpilled(context.getArena()));
+        auto in = context.getRawDataPtr<float *>(x);
+        for (size_t i = 0; i < x->size(); ++i)
+            in[i] = i;
+        context.run();
+        auto out = context.getRawDataPtr<float *>(g->getOutputs()[0]);
+        EXPECT_EQ(vector<float>(out, out + expected.size()), expected);
+    }
+
+    TEST(Spill, PageHints)
+    {
+        auto cpu = make_ref<NativeCpuRuntimeObj>();
+        cpu->setSpillDirectory(::testing::TempDir());
+        Runtime runtime = cpu;
+        auto g = makeGraph(runtime, 3);
+        g->dataMalloc();
+        auto &plan = g->getMemoryPlan();
+        auto &hints = g->getPageHints();
+        int steps = plan.getSteps();
+        ASSERT_EQ(hints.size(), size_t(steps));
+        EXPECT_TRUE(hints[steps - 1].willNeed.empty());
+        EXPECT_TRUE(hints[steps - 1].dontNeed.empty());
+
+        size_t page = sysconf(_SC_PAGESIZE);
+        auto covers = [](const vector<pair<size_t, size_t>> &ranges,
+                         size_t offset, size_t bytes)
+        {
+            return std::any_of(ranges.begin(), ranges.end(),
+                               [&](auto &r)
+                               {
+                                   return r.first <= offset &&
+                                          offset + bytes <= r.first + r.second;
+                               });
+        };
+        for (auto &p : plan.getPlacements())
+        {
+            // tensors are whole pages here, so their ranges are exact
+            ASSERT_EQ(p.offset % page, 0u);
+            ASSERT_EQ(p.bytes % page, 0u);
+            if (p.lastUse < steps - 1)
+            {
+                EXPECT_TRUE(
+                    covers(hints[p.lastUse].dontNeed, p.offset, p.bytes));
+            }
+            // nothing still live after a step is dropped by it
+            for (int step = p.firstUse; step < p.lastUse; ++step)
+                for (auto &[offset, bytes] : hints[step].dontNeed)
+                    EXPECT_TRUE(offset + bytes <= p.offset ||
+                                p.offset + p.bytes <= offset);
+        }
+        // each operator's inputs are read ahead a step earlier
+        auto &ops = g->getOperators();
+        for (int step = 0; step < steps; ++step)
+            for (auto &input : ops[step]->getInputs())
+                for (auto &p : plan.getPlacements())
+                {
+                    if (p.fuid != input->getFuid())
+                        continue;
+                    EXPECT_TRUE(covers(hints[std::max(step - 1, 0)].willNeed,
+                                       p.offset, p.bytes));
+                }
+    }
+
+    TEST(Spill, Threshold)
+    {
+        auto cpu = make_ref<NativeCpuRuntimeObj>();
+        cpu->setSpillDirectory(::testing::TempDir(), size_t(1) << 40);
+        auto g = makeGraph(cpu, 2);
+        g->dataMalloc();
+        EXPECT_TRUE(g->getPageHints().empty());
+
+        cpu->setSpillDirectory(::testing::TempDir(), 1 << 20);
+        void *small = cpu->alloc(1 << 10), *large = cpu->alloc(1 << 20);
+        EXPECT_FALSE(cpu->isSpilled(small));
+        EXPECT_TRUE(cpu->isSpilled(large));
+        static_cast<char *>(large)[(1 << 20) - 1] = 1;
+        cpu->dealloc(small);
+        cpu->dealloc(large);
+        EXPECT_FALSE(cpu->isSpilled(large));
+
+        cpu->setSpillDirectory("");
+        EXPECT_FALSE(cpu->shouldSpill(1 << 20));
+        EXPECT_THROW(cpu->mapSpillFile(1 << 20), Exception);
+    }
+
+} // namespace infini
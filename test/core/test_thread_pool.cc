@@ -0,0 +1,129 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "core/thread_pool.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(ThreadPool, ParallelFor)
+    {
+        ThreadPool pool(4);
+        EXPECT_EQ(pool.getThreadCount(), 4);
+        vector<std::atomic<int>> hits(10000);
+        std::mutex mutex;
+        vector<std::pair<size_t, size_t>> chunks;
+        pool.parallel_for(3, hits.size(), 100,
+                          [&](size_t begin, size_t end)
+                          {
+                              for (size_t i = begin; i < end; ++i)
+                                  ++hits[i];
+                              std::lock_guard<std::mutex> lock(mutex);
+                              chunks.emplace_back(begin, end);
+                          });
+        for (size_t i = 0; i < hits.size(); ++i)
+            EXPECT_EQ(hits[i], i >= 3 ? 1 : 0);
+        EXPECT_GT(chunks.size(), 1u);
+        for (auto &[begin, end] : chunks)
+            EXPECT_EQ((begin - 3) % 100, 0u);
+
+        // a loop of one chunk runs on the caller
+        auto caller = std::this_thread::get_id();
+        pool.parallel_for(0, 100, 100, [&](size_t begin, size_t end)
+                          { EXPECT_EQ(std::this_thread::get_id(), caller); });
+    }
+
+    TEST(ThreadPool, NestedAndExceptions)
+    {
+        ThreadPool pool(3);
+        std::atomic<size_t> sum{0};
+        pool.parallel_for(0, 8, 1,
+                          [&](size_t begin, size_t end)
+                          {
+                              pool.parallel_for(0, 10, 1,
+                                                [&](size_t b, size_t e)
+                                                { sum += e - b; });
+                          });
+        EXPECT_EQ(sum, 80u);
+
+        EXPECT_THROW(pool.parallel_for(0, 64, 1,
+                                       [](size_t begin, size_t end)
+                                       {
+                                           if (begin <= 40 && 40 < end)
+                                               IT_TODO_HALT();
+                                       }),
+                     Exception);
+        // the pool is usable after a failed loop
+        sum = 0;
+        pool.parallel_for(0, 64, 1, [&](size_t begin, size_t end)
+                          { sum += end - begin; });
+        EXPECT_EQ(sum, 64u);
+    }
+
+    TEST(ThreadPool, SharedPool)
+    {
+        auto pool = make_ref<ThreadPool>(2);
+        auto a = make_ref<NativeCpuRuntimeObj>();
+        auto b = make_ref<NativeCpuRuntimeObj>();
+        a->setThreadPool(pool);
+        b->setThreadPool(pool);
+        EXPECT_EQ(&a->getThreadPool(), &b->getThreadPool());
+        a->setThreadCount(1);
+        EXPECT_EQ(a->getThreadCount(), 1);
+        EXPECT_EQ(b->getThreadCount(), 2);
+    }
+
+    TEST(ThreadPool, Kernels)
+    {
+        // every kernel variant gives the same result with 1 and 4 threads
+        auto build = [](Runtime runtime)
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            auto a = g->addTensor({2, 64, 48}, DataType::Float32);
+            auto w = g->addTensor({48, 72}, DataType::Float32);
+            auto bias = g->addTensor({72}, DataType::Float32);
+            auto y = g->addOp<MatmulObj>(a, w, nullptr)->getOutput();
+            y = g->addOp<AddObj>(y, bias, nullptr)->getOutput();
+            auto z = g->addOp<TransposeObj>(y, nullptr, vector<int>{2, 0, 1})
+                         ->getOutput();
+            z = g->addOp<ReluObj>(z, nullptr)->getOutput();
+            z = g->addOp<ConcatObj>(TensorVec{z, z}, nullptr, 1)->getOutput();
+            g->dataMalloc();
+            a->setData(IncrementalGenerator());
+            w->setData([](void *ptr, size_t size, DataType)
+                       {
+                           for (size_t i = 0; i < size; ++i)
+                               ((float *)ptr)[i] = float(i % 7) - 3;
+                       });
+            bias->setData(IncrementalGenerator());
+            return g;
+        };
+        auto serial = make_ref<NativeCpuRuntimeObj>();
+        serial->setThreadCount(1);
+        auto parallel = make_ref<NativeCpuRuntimeObj>();
+        parallel->setThreadCount(4);
+        Graph expected = build(serial), actual = build(parallel);
+
+        auto &registry = KernelRegistry::getInstance();
+        auto &ops = expected->getOperators();
+        for (size_t i = 0; i < ops.size(); ++i)
+        {
+            auto attrs =
+                KernelAttrs{Device::CPU, ops[i]->getOpType().underlying()};
+            for (auto &[kernel, name, id] : registry.getKernelItems(attrs))
+            {
+                kernel->compute(ops[i], serial.get());
+                kernel->compute(actual->getOperators()[i], parallel.get());
+                EXPECT_TRUE(actual->getOperators()[i]->getOutput()->equalData(
+                    ops[i]->getOutput()))
+                    << name;
+            }
+        }
+    }
+} // namespace infini
@@ -0,0 +1,109 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "core/tuner.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include <fstream>
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(KernelTuner, TuneAndPersist)
+    {
+        Runtime runtime = make_ref<NativeCpuRuntimeObj>();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({2, 16, 32}, DataType::Float32);
+        auto b = g->addTensor({32, 8}, DataType::Float32);
+        auto t = g->addOp<TransposeObj>(a, nullptr, vector<int>{0, 2, 1});
+        auto mm = g->addOp<MatmulObj>(t->getOutput(), b, nullptr, true, false);
+        g->dataMalloc();
+        a->setData(IncrementalGenerator());
+        b->setData(OneGenerator());
+
+        auto &tuner = runtime->getTuner();
+        EXPECT_EQ(tuner.size(), 0u);
+        runtime->tune(g);
+        EXPECT_EQ(tuner.size(), 2u);
+        auto key = KernelTuner::getTuningKey(mm, Device::CPU);
+        auto name = std::get<1>(tuner.select(mm, Device::CPU));
+        EXPECT_EQ(tuner.getCache().at(key), name);
+
+        // Whichever variant wins, the result is the same.
+        Tensor expected = make_ref<TensorObj>(mm->getOutput()->getDims(),
+                                              DataType::Float32, runtime);
+        expected->setDataBlob(make_ref<BlobObj>(
+            runtime, runtime->alloc(expected->getBytes())));
+        runtime->run(g);
+        KernelRegistry::getInstance()
+            .getKernel(KernelAttrs{Device::CPU, OpType::MatMul})
+            ->compute(mm, runtime.get());
+        std::memcpy(expected->getRawDataPtr<void *>(),
+                    mm->getOutput()->getRawDataPtr<void *>(),
+                    expected->getBytes());
+        runtime->run(g);
+        EXPECT_TRUE(mm->getOutput()->equalData(expected));
+        runtime->dealloc(expected->getRawDataPtr<void *>());
+
+        auto path = ::testing::TempDir() + "tuner_cache.txt";
+        tuner.save(path);
+        KernelTuner loaded;
+        EXPECT_TRUE(loaded.load(path));
+        EXPECT_EQ(loaded.getCache(), tuner.getCache());
+        EXPECT_EQ(std::get<1>(loaded.select(mm, Device::CPU)), name);
+        EXPECT_FALSE(loaded.load(path + ".missing"));
+    }
+
+    TEST(KernelTuner, KeyHasAttributes)
+    {
+        Runtime runtime = make_ref<NativeCpuRuntimeObj>();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({8, 8}, DataType::Float32);
+        auto b = g->addTensor({8, 8}, DataType::Float32);
+        auto c = g->addTensor({2, 4, 8}, DataType::Float32);
+        // same input shapes, different layouts
+        auto plain = g->addOp<MatmulObj>(a, b, nullptr, false, false);
+        auto transB = g->addOp<MatmulObj>(a, b, nullptr, false, true);
+        auto t1 = g->addOp<TransposeObj>(c, nullptr, vector<int>{0, 2, 1});
+        auto t2 = g->addOp<TransposeObj>(c, nullptr, vector<int>{1, 0, 2});
+        EXPECT_NE(KernelTuner::getTuningKey(plain, Device::CPU),
+                  KernelTuner::getTuningKey(transB, Device::CPU));
+        EXPECT_NE(KernelTuner::getTuningKey(t1, Device::CPU),
+                  KernelTuner::getTuningKey(t2, Device::CPU));
+        auto again = g->addOp<MatmulObj>(a, b, nullptr, false, true);
+        EXPECT_EQ(KernelTuner::getTuningKey(transB, Device::CPU),
+                  KernelTuner::getTuningKey(again, Device::CPU));
+    }
+
+    TEST(KernelTuner, ResolvesPerOperator)
+    {
+        Runtime runtime = make_ref<NativeCpuRuntimeObj>();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor({4, 8}, DataType::Float32);
+        auto b = g->addTensor({8, 8}, DataType::Float32);
+        a->setInput();
+        auto mm = g->addOp<MatmulObj>(a, b, nullptr);
+        g->dataMalloc();
+
+        auto &tuner = runtime->getTuner();
+        auto name = [&] { return std::get<1>(tuner.select(mm, Device::CPU)); };
+        EXPECT_EQ(name(), "MatmulNaive_CPU");
+        // loading a winner replaces the variant resolved before
+        auto path = ::testing::TempDir() + "tuner_resolve.txt";
+        {
+            std::ofstream ofs(path);
+            ofs << KernelTuner::getTuningKey(mm, Device::CPU)
+                << "\tMatmulBlocked_CPU\n";
+        }
+        EXPECT_TRUE(tuner.load(path));
+        EXPECT_EQ(name(), "MatmulBlocked_CPU");
+        // other shapes have no winner
+        g->reshape({{a, {2, 8}}});
+        EXPECT_EQ(name(), "MatmulNaive_CPU");
+        g->reshape({{a, {4, 8}}});
+        EXPECT_EQ(name(), "MatmulBlocked_CPU");
+        tuner.clear();
+        EXPECT_EQ(name(), "MatmulNaive_CPU");
+    }
+} // namespace infini
@@ -0,0 +1,92 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "core/weight_arena.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini
+{
+    namespace
+    {
+        // Relu(MatMul(x, w)) with a weight w not bound to data.
+        Graph makeGraph(Runtime runtime)
+        {
+            Graph g = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({4, 8}, DataType::Float32);
+            auto w = g->addTensor({8, 3}, DataType::Float32);
+            x->setInput();
+            w->setWeight();
+            auto y = g->addOp<MatmulObj>(x, w, nullptr)->getOutput();
+            g->addOp<ReluObj>(y, nullptr);
+            return g;
+        }
+
+        vector<float> run(Runtime runtime, const Graph &g)
+        {
+            g->getInputs()[0]->setData(IncrementalGenerator());
+            runtime->run(g);
+            auto out = g->getOutputs()[0];
+            auto ptr = out->getRawDataPtr<float *>();
+            return vector<float>(ptr, ptr + out->size());
+        }
+    } // namespace
+
+    TEST(WeightArena, SeparateFromActivations)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto g = makeGraph(runtime);
+        auto w = g->getInputs()[1];
+        g->dataMalloc();
+        for (auto &p : g->getMemoryPlan().getPlacements())
+            EXPECT_NE(p.fuid, w->getFuid());
+        auto &arena = g->getWeightArena();
+        ASSERT_TRUE(arena);
+        EXPECT_EQ(arena->getCount(), 1u);
+        EXPECT_TRUE(arena->contains(w->getRawDataPtr<void *>()));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(w->getRawDataPtr<void *>()) %
+                      runtime->getAlignment(),
+                  0u);
+
+        w->setData(OneGenerator());
+        auto expected = run(runtime, g);
+        EXPECT_EQ(expected[3], 92);
+        arena->seal();
+        EXPECT_TRUE(arena->isSealed());
+        EXPECT_EQ(run(runtime, g), expected);
+
+        // planning again keeps the weights where they are
+        g->dataMalloc();
+        EXPECT_EQ(g->getWeightArena(), arena);
+        EXPECT_EQ(run(runtime, g), expected);
+
+        ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+        EXPECT_DEATH(w->getRawDataPtr<float *>()[0] = 2, "");
+    }
+
+    TEST(WeightArena, SharedByReplicas)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto g1 = makeGraph(runtime);
+        g1->dataMalloc();
+        g1->getInputs()[1]->setData(IncrementalGenerator());
+        g1->getWeightArena()->seal();
+        auto expected = run(runtime, g1);
+
+        auto g2 = makeGraph(runtime);
+        g2->setWeightArena(g1->getWeightArena());
+        g2->dataMalloc();
+        EXPECT_EQ(g2->getWeightArena(), g1->getWeightArena());
+        EXPECT_EQ(g2->getInputs()[1]->getRawDataPtr<void *>(),
+                  g1->getInputs()[1]->getRawDataPtr<void *>());
+        EXPECT_NE(g2->getInputs()[0]->getRawDataPtr<void *>(),
+                  g1->getInputs()[0]->getRawDataPtr<void *>());
+        EXPECT_EQ(run(runtime, g2), expected);
+
+        // weights of another shape do not fit
+        Graph other = make_ref<GraphObj>(runtime);
+        other->addTensor({8, 4}, DataType::Float32)->setWeight();
+        EXPECT_THROW(other->setWeightArena(g1->getWeightArena()), Exception);
+    }
+} // namespace infini
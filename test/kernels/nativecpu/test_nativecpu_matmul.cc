@@ -0,0 +1,40 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+
+#include "test.h"
+
+namespace infini {
+
+void testMatmulNativeCpu(const Shape &shapeA, const Shape &shapeB, bool transA,
+                         bool transB, const vector<float> &ansVec) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    auto &registry = KernelRegistry::getInstance();
+    auto kernelAttrs = KernelAttrs{Device::CPU, OpType::MatMul};
+    EXPECT_GE(registry.getKernelItems(kernelAttrs).size(), 2u);
+    for (auto &[kernel, name, id] : registry.getKernelItems(kernelAttrs)) {
+        Graph g = make_ref<GraphObj>(runtime);
+        auto a = g->addTensor(shapeA, DataType::Float32);
+        auto b = g->addTensor(shapeB, DataType::Float32);
+        auto op = g->addOp<MatmulObj>(a, b, nullptr, transA, transB);
+        g->dataMalloc();
+        a->setData(IncrementalGenerator());
+        b->setData(IncrementalGenerator());
+        kernel->compute(op, runtime.get());
+        EXPECT_TRUE(op->getOutput()->equalData(ansVec)) << name;
+    }
+}
+
+TEST(Matmul, NativeCpu) {
+    testMatmulNativeCpu(Shape{1, 2, 3}, Shape{1, 3, 2}, false, false,
+                        vector<float>{10, 13, 28, 40});
+    testMatmulNativeCpu(Shape{2, 2, 3}, Shape{3, 2}, false, false,
+                        vector<float>{10, 13, 28, 40, 46, 67, 64, 94});
+    testMatmulNativeCpu(Shape{2, 3}, Shape{2, 3}, false, true,
+                        vector<float>{5, 14, 14, 50});
+    testMatmulNativeCpu(Shape{3, 2}, Shape{3, 2}, true, false,
+                        vector<float>{20, 26, 26, 35});
+}
+
+} // namespace infini
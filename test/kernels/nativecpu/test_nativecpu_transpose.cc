@@ -24,4 +24,22 @@ TEST(Transpose, NativeCpu) {
                                                           8, 9, 10, 11, 20, 21, 22, 23}));
 }
 
+TEST(Transpose, NativeCpuVariants) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    auto &registry = KernelRegistry::getInstance();
+    auto kernelAttrs = KernelAttrs{Device::CPU, OpType::Transpose};
+    for (auto &[kernel, name, id] : registry.getKernelItems(kernelAttrs)) {
+        Graph g = make_ref<GraphObj>(runtime);
+        auto input = g->addTensor({2, 3, 4}, DataType::Float32);
+        auto op = g->addOp<TransposeObj>(input, nullptr, vector<int>{2, 0, 1});
+        g->dataMalloc();
+        input->setData(IncrementalGenerator());
+        kernel->compute(op, runtime.get());
+        EXPECT_TRUE(op->getOutput(0)->equalData(
+            vector<float>{0, 4, 8, 12, 16, 20, 1, 5, 9, 13, 17, 21,
+                          2, 6, 10, 14, 18, 22, 3, 7, 11, 15, 19, 23}))
+            << name;
+    }
+}
+
 } // namespace infini